@@ -0,0 +1,57 @@
+#include "alloc_counter.h"
+#include <errno.h>
+
+// malloc-counting shim: interposes the C allocation functions and forwards to glibc
+extern "C" {
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t n, size_t size);
+	void *__libc_realloc(void *ptr, size_t size);
+	void *__libc_memalign(size_t alignment, size_t size);
+}
+
+// Per-thread so that benchmark threads do not see each other's (or the harness's) allocations.
+// A trivially constructible thread_local in the executable needs no allocation itself.
+static thread_local size_t n_allocations = 0;
+
+static inline void countAllocation() {
+	n_allocations++;
+}
+
+size_t bench::allocationCount() {
+	return n_allocations;
+}
+
+extern "C" void *malloc(size_t size) {
+	countAllocation();
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+	countAllocation();
+	return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+	countAllocation();
+	return __libc_realloc(ptr, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) {
+	countAllocation();
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) {
+	countAllocation();
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **ptr, size_t alignment, size_t size) {
+	countAllocation();
+	void *p = __libc_memalign(alignment, size);
+	if (p == nullptr) {
+		return ENOMEM;
+	}
+	*ptr = p;
+	return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef __BENCH_ALLOC_COUNTER__
+#define __BENCH_ALLOC_COUNTER__
+
+#include <stddef.h>
+
+namespace bench {
+	// Number of heap allocations made by the calling thread (malloc, calloc, realloc, aligned variants and
+	// everything routed through them, e.g. operator new) since it started
+	size_t allocationCount();
+
+} /*namespace bench*/
+
+#endif /*__BENCH_ALLOC_COUNTER__*/
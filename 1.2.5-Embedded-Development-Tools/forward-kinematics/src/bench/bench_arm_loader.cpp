@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include "kinematics/arm_loader.h"
+
+// Writes a planar zig-zag chain with the given number of joints, or returns the course arm for 4
+static std::string descriptionPath(int n_joints) {
+	if (n_joints == 4) {
+		return FK_ARMS_DIR "/course_arm.txt";
+	}
+	std::string path = std::string(FK_BENCH_DIR) + "/chain_" + std::to_string(n_joints) + ".txt";
+	FILE *f = fopen(path.c_str(), "w");
+	for (int i = 0; i < n_joints; i++) {
+		fprintf(f, "joint %d %d 0   0 0 %d   -3.14159 3.14159\n", i % 2, 1 - i % 2, 50 * i);
+	}
+	fprintf(f, "home 1 0 0 0\n     0 1 0 0\n     0 0 1 %d\n", 50 * n_joints);
+	fclose(f);
+	return path;
+}
+
+// Startup cost without a cache: parse the text and precompute the screws
+static void BM_ParseArmDescription(benchmark::State &state) {
+	std::string description = descriptionPath(state.range(0));
+	for (auto _ : state) {
+		kinematics::RobotModel model = kinematics::parseArmDescription(description.c_str());
+		benchmark::DoNotOptimize(model);
+	}
+}
+BENCHMARK(BM_ParseArmDescription)->Arg(4)->Arg(64);
+
+// Startup cost with a fresh cache: open, check the header and read the sections
+static void BM_LoadModelCache(benchmark::State &state) {
+	std::string description = descriptionPath(state.range(0));
+	std::string cache = std::string(FK_BENCH_DIR) + "/model_" + std::to_string(state.range(0)) + ".bin";
+	kinematics::RobotModel parsed = kinematics::parseArmDescription(description.c_str());
+	if (!kinematics::writeModelCache(parsed, cache.c_str(), description.c_str())) {
+		state.SkipWithError("cannot write the model cache");
+		return;
+	}
+	for (auto _ : state) {
+		kinematics::CachedRobotModel cached;
+		if (!cached.load(cache.c_str(), description.c_str())) {
+			state.SkipWithError("cache rejected");
+			break;
+		}
+		benchmark::DoNotOptimize(cached.get()->nJoints());
+	}
+	// The cache must reproduce the parsed model exactly
+	kinematics::CachedRobotModel cached;
+	cached.load(cache.c_str(), description.c_str());
+	const kinematics::RobotModel &m = *cached.get();
+	bool same = m.nJoints() == parsed.nJoints() && memcmp(&m.home(), &parsed.home(), sizeof(m.home())) == 0;
+	for (int i = 0; same && i < m.nJoints(); i++) {
+		same = memcmp(&m.screw(i), &parsed.screw(i), sizeof(kinematics::Screw)) == 0 &&
+		       memcmp(&m.bodyScrew(i), &parsed.bodyScrew(i), sizeof(kinematics::Screw)) == 0 &&
+		       memcmp(&m.jointSpec(i), &parsed.jointSpec(i), sizeof(kinematics::JointSpec)) == 0 &&
+		       m.jointLower(i) == parsed.jointLower(i) && m.jointUpper(i) == parsed.jointUpper(i) &&
+		       memcmp(&m.linkInertia(i), &parsed.linkInertia(i), sizeof(kinematics::LinkInertia)) == 0;
+	}
+	if (!same) {
+		state.SkipWithError("cached model differs from the parsed one");
+	}
+	struct stat st;
+	stat(cache.c_str(), &st);
+	state.counters["cache_bytes"] = (double)st.st_size;
+}
+BENCHMARK(BM_LoadModelCache)->Arg(4)->Arg(64);
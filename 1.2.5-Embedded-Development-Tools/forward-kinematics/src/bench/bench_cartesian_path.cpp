@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "kinematics/arm_specs.h"
+#include "kinematics/cartesian_path.h"
+#include "kinematics/fk.h"
+#include "kinematics/fk_batch.h"
+#include "kinematics/ik.h"
+
+static const int N_POSES = 1024;
+
+static float transformError(const linalg::Transform &a, const linalg::Transform &b) {
+	float e = linalg::norm(a.p - b.p) * 1e-3f;
+	for (int k = 0; k < 9; k++) {
+		e = fmaxf(e, fabsf(a.R.m[k] - b.R.m[k]));
+	}
+	return e;
+}
+
+// Start and end poses of a move of the course arm
+static void makeMove(const kinematics::RobotModel &model, linalg::Transform &from, linalg::Transform &to) {
+	const float q0[4] = {-0.7f, 0.3f, 0.8f, 0.4f};
+	const float q1[4] = {0.9f, 0.6f, 0.2f, 1.1f};
+	kinematics::forwardKinematics(model, q0, from);
+	kinematics::forwardKinematics(model, q1, to);
+}
+
+// exp(log(T)) round trips, path ends, and the screw path's midpoint halving the move
+static bool checkPaths(const kinematics::RobotModel &model) {
+	unsigned seed = 99;
+	for (int i = 0; i < 256; i++) {
+		float q[4];
+		for (int j = 0; j < 4; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			// Up to pi per joint, so the rotation angle covers [0, pi]
+			q[j] = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * 3.1f;
+		}
+		linalg::Transform T;
+		kinematics::forwardKinematics(model, q, T);
+		if (transformError(kinematics::expTwist(kinematics::logTransform(T)), T) > 1e-5f) {
+			return false;
+		}
+	}
+	linalg::Transform from, to;
+	makeMove(model, from, to);
+	for (int mode = kinematics::INTERP_SCREW; mode <= kinematics::INTERP_DECOUPLED; mode++) {
+		kinematics::CartesianPath path(from, to, (kinematics::CartesianInterpolation)mode);
+		if (transformError(path.at(0.0f), from) > 1e-4f || transformError(path.at(1.0f), to) > 1e-3f) {
+			return false;
+		}
+	}
+	kinematics::CartesianPath screw(from, to);
+	linalg::Transform half = linalg::compose(linalg::inverse(from), screw.at(0.5f));
+	return transformError(linalg::compose(from, linalg::compose(half, half)), to) < 1e-3f;
+}
+
+// K poses in one pass with the twist computed once
+static void BM_CartesianPathSample(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	if (!checkPaths(model)) {
+		state.SkipWithError("SE(3) log/exp or path interpolation is wrong");
+		return;
+	}
+	linalg::Transform from, to;
+	makeMove(model, from, to);
+	kinematics::CartesianPath path(from, to, (kinematics::CartesianInterpolation)state.range(0));
+	std::vector<linalg::Transform> poses(N_POSES);
+	for (auto _ : state) {
+		path.sampleUniform(N_POSES, poses.data());
+		benchmark::DoNotOptimize(poses.data());
+	}
+	state.SetLabel(state.range(0) == kinematics::INTERP_SCREW ? "screw" : "decoupled");
+	state.counters["poses/s"] = benchmark::Counter(state.iterations() * N_POSES, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CartesianPathSample)->Arg(kinematics::INTERP_SCREW)->Arg(kinematics::INTERP_DECOUPLED);
+
+// Baseline: from * exp(s log(from^-1 to)) recomputed for every pose
+static void BM_CartesianPathNaive(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform from, to;
+	makeMove(model, from, to);
+	std::vector<linalg::Transform> poses(N_POSES);
+	for (auto _ : state) {
+		for (int k = 0; k < N_POSES; k++) {
+			float s = (float)k / (N_POSES - 1);
+			kinematics::Twist V = kinematics::logTransform(linalg::compose(linalg::inverse(from), to));
+			poses[k] = linalg::compose(from, kinematics::expTwist(kinematics::Twist{V.w * s, V.v * s}));
+		}
+		benchmark::DoNotOptimize(poses.data());
+	}
+	state.counters["poses/s"] = benchmark::Counter(state.iterations() * N_POSES, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CartesianPathNaive);
+
+// A straight-line move followed by position IK at every pose, warm-started along the path
+static void BM_CartesianPathIk(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform from, to;
+	makeMove(model, from, to);
+	kinematics::CartesianPath path(from, to, kinematics::INTERP_DECOUPLED);
+	const int n = state.range(0);
+	std::vector<linalg::Transform> poses(n);
+	path.sampleUniform(n, poses.data());
+	kinematics::IkOptions options;
+	options.use_orientation = false;
+	kinematics::IkSolver solver(model, options);
+	const float q0[4] = {-0.7f, 0.3f, 0.8f, 0.4f};
+	float thetas[4];
+	long failures = 0, solves = 0, iterations = 0;
+	for (auto _ : state) {
+		solver.seed(q0);
+		for (int k = 0; k < n; k++) {
+			kinematics::IkResult r = solver.solve(poses[k], thetas);
+			failures += !r.converged;
+			iterations += r.iterations;
+			solves++;
+		}
+	}
+	state.counters["failure_rate"] = (double)failures / solves;
+	state.counters["iterations"] = (double)iterations / solves;
+	state.counters["poses/s"] = benchmark::Counter(solves, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CartesianPathIk)->Arg(64)->Arg(256);
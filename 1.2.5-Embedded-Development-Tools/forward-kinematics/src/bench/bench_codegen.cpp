@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "fk_course_arm.h"
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/jacobian.h"
+
+// Largest entry-wise difference between the generated code and the generic PoE over a sweep of configurations
+static float crossCheck(const kinematics::RobotModel &model) {
+	float worst = 0;
+	for (int k = 0; k < 1000; k++) {
+		float thetas[4] = {0.013f * k - 6.0f, 0.7f - 0.002f * k, 0.005f * k, 2.0f - 0.004f * k};
+		linalg::Transform ref, gen;
+		kinematics::Twist J_ref[4], J_gen[4];
+		kinematics::fkWithJacobian(model, thetas, ref, J_ref);
+		kinematics::generated::fk_jacobian_course_arm(thetas, gen, J_gen);
+		float err = linalg::norm(ref.p - gen.p);
+		for (int i = 0; i < 4; i++) {
+			err += linalg::norm(J_ref[i].w - J_gen[i].w) + linalg::norm(J_ref[i].v - J_gen[i].v);
+		}
+		kinematics::generated::fk_course_arm(thetas, gen);
+		err += linalg::norm(ref.p - gen.p);
+		for (int q = 0; q < 9; q++) {
+			err += fabsf(ref.R.m[q] - gen.R.m[q]);
+		}
+		worst = err > worst ? err : worst;
+	}
+	return worst;
+}
+
+static void BM_FkGenerated(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	float error = crossCheck(model);
+	if (error > 1e-2f) {
+		state.SkipWithError("generated FK disagrees with the generic PoE");
+	}
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T;
+	for (auto _ : state) {
+		kinematics::generated::fk_course_arm(thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+	state.counters["max_error"] = error;
+}
+BENCHMARK(BM_FkGenerated);
+
+static void BM_FkJacobianGenerated(benchmark::State &state) {
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T;
+	kinematics::Twist J[4];
+	for (auto _ : state) {
+		kinematics::generated::fk_jacobian_course_arm(thetas, T, J);
+		benchmark::DoNotOptimize(T);
+		benchmark::DoNotOptimize(J);
+		thetas[0] += 1e-6f;
+	}
+}
+BENCHMARK(BM_FkJacobianGenerated);
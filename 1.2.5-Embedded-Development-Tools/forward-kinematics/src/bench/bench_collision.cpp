@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include <vector>
+#include "kinematics/arm_specs.h"
+#include "kinematics/collision.h"
+
+static const long N_CONFIGS = 1 << 16;
+
+// Random joint angles, row-major
+static std::vector<float> makeTrajectory(long n) {
+	std::vector<float> thetas(n * 4);
+	unsigned seed = 4242;
+	for (float &t : thetas) {
+		seed = seed * 1664525u + 1013904223u;
+		t = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * 2.5f;
+	}
+	return thetas;
+}
+
+// Course arm over a table, with a bar in front of it, a post to the side and a ball behind it
+static void addObstacles(kinematics::CollisionModel &collision) {
+	collision.addObstacle(kinematics::Capsule{{-300.0f, -300.0f, -40.0f}, {300.0f, 300.0f, -40.0f}, 15.0f});
+	collision.addObstacle(kinematics::Capsule{{-100.0f, 120.0f, 100.0f}, {100.0f, 120.0f, 100.0f}, 15.0f});
+	collision.addObstacle(kinematics::Capsule{{150.0f, 0.0f, 0.0f}, {150.0f, 0.0f, 200.0f}, 20.0f});
+	// A sphere is a capsule with a == b
+	collision.addObstacle(kinematics::Capsule{{-120.0f, -80.0f, 160.0f}, {-120.0f, -80.0f, 160.0f}, 30.0f});
+}
+
+// Closest distances with known answers, points (spheres) on either side included
+static bool checkSegmentDistance() {
+	typedef linalg::Vec3 V;
+	const struct {
+		V p1, q1, p2, q2;
+		float distance;
+	} cases[] = {
+		{{0, 0, 0}, {100, 0, 0}, {50, 10, 0}, {50, 10, 0}, 10.0f},
+		{{50, 10, 0}, {50, 10, 0}, {0, 0, 0}, {100, 0, 0}, 10.0f},
+		{{0, 0, 0}, {100, 0, 0}, {130, 40, 0}, {130, 40, 0}, 50.0f},
+		{{0, 0, 0}, {0, 0, 0}, {3, 4, 0}, {3, 4, 0}, 5.0f},
+		{{0, 0, 0}, {100, 0, 0}, {50, -20, 30}, {50, 20, 30}, 30.0f},
+		{{0, 0, 0}, {100, 0, 0}, {120, 5, 0}, {200, 5, 0}, sqrtf(425.0f)},
+		{{0, 0, 0}, {100, 0, 0}, {0, 7, 0}, {100, 7, 0}, 7.0f},
+	};
+	for (const auto &c : cases) {
+		if (fabsf(sqrtf(kinematics::segmentDistance2(c.p1, c.q1, c.p2, c.q2)) - c.distance) > 1e-3f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// One configuration at a time on the scalar path
+static void BM_CollisionScalar(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::LinkCapsule links[4];
+	kinematics::makeCourseArmCapsules(arm, links);
+	kinematics::CollisionModel collision(model, links, 4, 2.0f);
+	addObstacles(collision);
+	std::vector<float> thetas = makeTrajectory(N_CONFIGS);
+	if (!checkSegmentDistance()) {
+		state.SkipWithError("segmentDistance2 is wrong");
+		return;
+	}
+
+	long checks = 0, hits = 0;
+	for (auto _ : state) {
+		hits += collision.inCollision(&thetas[(checks % N_CONFIGS) * 4]);
+		checks++;
+	}
+	state.counters["checks/s"] = benchmark::Counter(checks, benchmark::Counter::kIsRate);
+	state.counters["colliding"] = (double)hits / checks;
+}
+BENCHMARK(BM_CollisionScalar);
+
+// Whole trajectories in FK_LANES-wide blocks, checked against the scalar path
+static void BM_CollisionTrajectory(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::LinkCapsule links[4];
+	kinematics::makeCourseArmCapsules(arm, links);
+	kinematics::CollisionModel collision(model, links, 4, 2.0f);
+	addObstacles(collision);
+	// Odd length so the last block is padded
+	const long n = N_CONFIGS - 3;
+	std::vector<float> thetas = makeTrajectory(n);
+	std::vector<uint8_t> flags(n);
+
+	long expected = 0, mismatches = 0;
+	collision.checkTrajectory(thetas.data(), n, flags.data());
+	for (long i = 0; i < n; i++) {
+		kinematics::CollisionReport report;
+		bool hit = collision.inCollision(&thetas[i * 4], &report);
+		expected += hit;
+		// Lanes and scalar code round differently, only count disagreements away from contact
+		if (hit != (flags[i] != 0) && fabsf(report.distance - 2.0f) > 1e-2f) {
+			mismatches++;
+		}
+	}
+	if (mismatches > 0) {
+		state.SkipWithError("batched check disagrees with the scalar check");
+		return;
+	}
+
+	omp_set_num_threads(state.range(0));
+	long colliding = 0;
+	for (auto _ : state) {
+		colliding = collision.checkTrajectory(thetas.data(), n, flags.data());
+		benchmark::DoNotOptimize(flags.data());
+	}
+	omp_set_num_threads(omp_get_num_procs());
+	state.counters["checks/s"] = benchmark::Counter(state.iterations() * n, benchmark::Counter::kIsRate);
+	state.counters["colliding"] = (double)colliding / n;
+	state.counters["scalar_colliding"] = (double)expected / n;
+}
+static void threadCounts(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int t = 1; t < n_procs; t *= 2) {
+		b->Arg(t);
+	}
+	b->Arg(n_procs);
+}
+BENCHMARK(BM_CollisionTrajectory)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
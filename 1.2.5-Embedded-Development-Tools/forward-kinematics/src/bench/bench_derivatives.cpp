@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include "kinematics/derivatives.h"
+
+static const float THETAS[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+
+static void armPose(const kinematics::RoboticArmSpecs &arm, int k, float h, linalg::Transform &T) {
+	float thetas[4] = {THETAS[0], THETAS[1], THETAS[2], THETAS[3]};
+	float L[3] = {arm.L1, arm.L2, arm.L3};
+	if (k < 4) {
+		thetas[k] += h;
+	} else {
+		L[k - 4] += h;
+	}
+	kinematics::JointSpec joints[4];
+	linalg::Transform M;
+	kinematics::buildArmJoints(L[0], L[1], L[2], joints, M);
+	kinematics::forwardKinematicsT(joints, 4, M, thetas, T);
+}
+
+// Finite differences over theta1..4 and L1..L3, rebuilding the joint specs for each length.
+// Forward differences cost N+1 evaluations; central ones cost 2N but are accurate enough to check against.
+static void armFiniteDifferences(const kinematics::RoboticArmSpecs &arm, bool central, linalg::Transform *dT) {
+	const float h = 1e-2f;
+	linalg::Transform T0, T_plus, T_minus;
+	if (!central) {
+		armPose(arm, 0, 0.0f, T0);
+	}
+	for (int k = 0; k < 7; k++) {
+		armPose(arm, k, h, T_plus);
+		if (central) {
+			armPose(arm, k, -h, T_minus);
+		} else {
+			T_minus = T0;
+		}
+		float scale = central ? 1.0f / (2 * h) : 1.0f / h;
+		for (int j = 0; j < 9; j++) {
+			dT[k].R.m[j] = (T_plus.R.m[j] - T_minus.R.m[j]) * scale;
+		}
+		dT[k].p = (T_plus.p - T_minus.p) * scale;
+	}
+}
+
+static void BM_ArmDerivativesDual(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	linalg::Transform T, dT[7], dT_fd[7];
+	kinematics::fkArmDerivatives(arm, THETAS, T, dT);
+	armFiniteDifferences(arm, true, dT_fd);
+	for (int k = 0; k < 7; k++) {
+		if (linalg::norm(dT[k].p - dT_fd[k].p) > 1e-2f) {
+			state.SkipWithError("dual derivatives disagree with finite differences");
+		}
+	}
+	for (auto _ : state) {
+		kinematics::fkArmDerivatives(arm, THETAS, T, dT);
+		benchmark::DoNotOptimize(dT);
+	}
+}
+BENCHMARK(BM_ArmDerivativesDual);
+
+static void BM_ArmDerivativesFiniteDiff(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	linalg::Transform T, dT[7], dT_dual[7];
+	for (auto _ : state) {
+		armFiniteDifferences(arm, false, dT);
+		benchmark::DoNotOptimize(dT);
+	}
+	// Truncation and rounding error of forward differences, taking the dual result as exact
+	kinematics::fkArmDerivatives(arm, THETAS, T, dT_dual);
+	float worst = 0;
+	for (int k = 0; k < 7; k++) {
+		float err = linalg::norm(dT[k].p - dT_dual[k].p);
+		worst = err > worst ? err : worst;
+	}
+	state.counters["max_error_mm"] = worst;
+}
+BENCHMARK(BM_ArmDerivativesFiniteDiff);
+
+// Joint-angle derivatives of a RobotModel through the generic parameter interface
+static void BM_ModelThetaDerivativesDual(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const kinematics::FkParameter params[4] = {{kinematics::FkParameter::THETA, 0}, {kinematics::FkParameter::THETA, 1},
+						   {kinematics::FkParameter::THETA, 2}, {kinematics::FkParameter::THETA, 3}};
+	linalg::Transform T, dT[4];
+	for (auto _ : state) {
+		kinematics::fkDerivatives<4>(model, THETAS, params, T, dT);
+		benchmark::DoNotOptimize(dT);
+	}
+}
+BENCHMARK(BM_ModelThetaDerivativesDual);
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include <string>
+#include <vector>
+#include "alloc_counter.h"
+#include "kinematics/arm_specs.h"
+#include "kinematics/dynamics.h"
+#include "kinematics/fk_scan.h"
+#include "kinematics/trajectory.h"
+
+static const float MAX_VELOCITY[4] = {4.0f, 3.0f, 3.0f, 5.0f};
+static const float MAX_ACCELERATION[4] = {20.0f, 12.0f, 12.0f, 30.0f};
+static const float PERIOD = 1e-3f;
+
+static kinematics::Trajectory makeTrajectory(const kinematics::RobotModel &model) {
+	const float waypoints[4 * 4] = {
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.8f, 0.9f, 1.2f, 0.4f,
+		-0.6f, -0.4f, 0.7f, -0.5f,
+		0.0f, 0.0f, 0.0f, 0.0f};
+	return kinematics::Trajectory(model, waypoints, 4, kinematics::PROFILE_QUINTIC, MAX_VELOCITY, MAX_ACCELERATION);
+}
+
+// Potential energy -sum m_i g . com_i(q) from the link frames, J
+static double potentialEnergy(const kinematics::RobotModel &model, const float *q) {
+	linalg::Transform frames[kinematics::MAX_JOINTS], tool;
+	kinematics::fkLinkFrames(model, q, frames, tool);
+	double P = 0.0;
+	for (int i = 0; i < model.nJoints(); i++) {
+		const kinematics::LinkInertia &link = model.linkInertia(i);
+		linalg::Vec3 c = linalg::transformPoint(frames[i], link.com);
+		P -= link.mass * linalg::dot(kinematics::STANDARD_GRAVITY, c);
+	}
+	return P * kinematics::MODEL_TORQUE_TO_NM;
+}
+
+// Holding torques against finite differences of the potential energy, a symmetric
+// mass matrix, and power balance d(K + P)/dt = tau . qd along the trajectory
+static std::string checkDynamics(const kinematics::RobotModel &model, const kinematics::InverseDynamics &dynamics) {
+	const float q0[4] = {0.4f, 0.7f, -0.5f, 1.1f};
+	float g[4];
+	dynamics.gravityTorques(q0, g);
+	for (int j = 0; j < 4; j++) {
+		const float h = 1e-3f;
+		float qp[4], qm[4];
+		for (int k = 0; k < 4; k++) {
+			qp[k] = qm[k] = q0[k];
+		}
+		qp[j] += h;
+		qm[j] -= h;
+		double fd = (potentialEnergy(model, qp) - potentialEnergy(model, qm)) / (2.0 * h);
+		if (fabs(fd - g[j]) > 1e-3 * fabs(fd) + 1e-5) {
+			return "gravity torques disagree with the potential energy";
+		}
+	}
+	float M[16];
+	dynamics.massMatrix(q0, M);
+	for (int i = 0; i < 4; i++) {
+		if (!(M[i * 4 + i] > 0)) {
+			return "mass matrix is not positive";
+		}
+		for (int j = 0; j < i; j++) {
+			if (fabsf(M[i * 4 + j] - M[j * 4 + i]) > 1e-4f * M[i * 4 + i]) {
+				return "mass matrix is not symmetric";
+			}
+		}
+	}
+
+	kinematics::Trajectory traj = makeTrajectory(model);
+	long n = traj.samplesAtPeriod(PERIOD);
+	std::vector<float> q(n * 4), qd(n * 4), qdd(n * 4), tau(n * 4);
+	traj.sampleUniform(0.0f, PERIOD, n, q.data(), qd.data(), qdd.data());
+	dynamics.torquesBatch(q.data(), qd.data(), qdd.data(), n, tau.data());
+	std::vector<double> energy(n);
+	double max_power = 0.0;
+	for (long k = 0; k < n; k++) {
+		dynamics.massMatrix(&q[k * 4], M);
+		double kinetic = 0.0, power = 0.0;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				kinetic += 0.5 * qd[k * 4 + i] * M[i * 4 + j] * qd[k * 4 + j];
+			}
+			power += tau[k * 4 + i] * qd[k * 4 + i];
+		}
+		energy[k] = kinetic + potentialEnergy(model, &q[k * 4]);
+		max_power = fmax(max_power, fabs(power));
+	}
+	for (long k = 1; k + 1 < n; k++) {
+		double power = 0.0;
+		for (int i = 0; i < 4; i++) {
+			power += tau[k * 4 + i] * qd[k * 4 + i];
+		}
+		double dE = (energy[k + 1] - energy[k - 1]) / (2.0 * PERIOD);
+		if (fabs(dE - power) > 0.02 * max_power) {
+			return "torques break the power balance";
+		}
+	}
+	return "";
+}
+
+// One RNEA solve, checked to make no allocation
+static void BM_InverseDynamics(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::InverseDynamics dynamics(model);
+	std::string error = checkDynamics(model, dynamics);
+	if (!error.empty()) {
+		state.SkipWithError(error.c_str());
+		return;
+	}
+	const float q[4] = {0.4f, 0.7f, -0.5f, 1.1f}, qd[4] = {1.0f, -2.0f, 0.5f, 3.0f}, qdd[4] = {5.0f, 2.0f, -8.0f, 1.0f};
+	float tau[4];
+	size_t allocs_before = bench::allocationCount();
+	for (auto _ : state) {
+		dynamics.torques(q, qd, qdd, tau);
+		benchmark::DoNotOptimize(tau);
+	}
+	if (bench::allocationCount() != allocs_before) {
+		state.SkipWithError("InverseDynamics allocated memory");
+	}
+}
+BENCHMARK(BM_InverseDynamics);
+
+// Torques along a 1 kHz trajectory, with the peak holding and moving torque per joint
+static void BM_InverseDynamicsBatch(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::InverseDynamics dynamics(model);
+	kinematics::Trajectory traj = makeTrajectory(model);
+	long n = traj.samplesAtPeriod(PERIOD);
+	std::vector<float> q(n * 4), qd(n * 4), qdd(n * 4), tau(n * 4);
+	traj.sampleUniform(0.0f, PERIOD, n, q.data(), qd.data(), qdd.data());
+	omp_set_num_threads(state.range(0));
+	for (auto _ : state) {
+		dynamics.torquesBatch(q.data(), qd.data(), qdd.data(), n, tau.data());
+		benchmark::DoNotOptimize(tau.data());
+	}
+	omp_set_num_threads(omp_get_num_procs());
+	float peak[4] = {0, 0, 0, 0};
+	for (long k = 0; k < n; k++) {
+		for (int j = 0; j < 4; j++) {
+			peak[j] = fmaxf(peak[j], fabsf(tau[k * 4 + j]));
+		}
+	}
+	// Servo stall torques are quoted in kg cm; 1 N m = 10.2 kg cm
+	for (int j = 0; j < 4; j++) {
+		state.counters["peak_kgcm_" + std::to_string(j)] = peak[j] * 10.197f;
+	}
+	state.counters["samples/s"] = benchmark::Counter(state.iterations() * n, benchmark::Counter::kIsRate);
+}
+static void threadCounts(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int t = 1; t < n_procs; t *= 2) {
+		b->Arg(t);
+	}
+	b->Arg(n_procs);
+}
+BENCHMARK(BM_InverseDynamicsBatch)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,27 @@
+#include <benchmark/benchmark.h>
+#include "alloc_counter.h"
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+
+static void BM_ForwardKinematics(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	static const kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T;
+
+	size_t allocs_before = bench::allocationCount();
+	for (auto _ : state) {
+		kinematics::forwardKinematics(model, thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+	size_t allocs = bench::allocationCount() - allocs_before;
+
+	// The production FK path must never touch the heap
+	state.counters["allocs"] = allocs;
+	if (allocs != 0) {
+		state.SkipWithError("forwardKinematics allocated memory");
+	}
+}
+// Threads share one model to check that concurrent calls are safe
+BENCHMARK(BM_ForwardKinematics)->ThreadRange(1, 8);
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk_batch.h"
+
+static const long N_POSES = 1 << 20;
+
+// Poses per second against the number of OpenMP threads
+static void BM_FkBatch(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	int n_threads = state.range(0);
+	omp_set_num_threads(n_threads);
+
+	float *thetas = (float *)kinematics::allocBatchBuffer(N_POSES, arm.N_JOINTS * sizeof(float));
+	linalg::Transform *poses = (linalg::Transform *)kinematics::allocBatchBuffer(N_POSES, sizeof(linalg::Transform));
+	for (long i = 0; i < N_POSES * arm.N_JOINTS; i++) {
+		thetas[i] = (float)(i % 628) * 0.01f;
+	}
+
+	for (auto _ : state) {
+		kinematics::fkBatch(model, thetas, poses, N_POSES);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * N_POSES);
+	state.counters["threads"] = n_threads;
+
+	kinematics::freeBatchBuffer(thetas);
+	kinematics::freeBatchBuffer(poses);
+	omp_set_num_threads(omp_get_num_procs());
+}
+
+// 1, 2, 4, ... up to the number of cores
+static void threadCounts(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int t = 1; t < n_procs; t *= 2) {
+		b->Arg(t);
+	}
+	b->Arg(n_procs);
+}
+BENCHMARK(BM_FkBatch)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
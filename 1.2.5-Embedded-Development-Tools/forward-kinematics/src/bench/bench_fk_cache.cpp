@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include <string.h>
+#include <vector>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/fk_cache.h"
+
+static const long N_QUERIES = 1 << 16;
+static const float DEG = (float)(M_PI / 180.0);
+
+// Planner-like queries: a random walk in whole degrees within +-45 degrees of home,
+// so configurations come back often but not in order
+static std::vector<float> makeQueries() {
+	std::vector<float> thetas(N_QUERIES * 4);
+	int q[4] = {0, 0, 0, 0};
+	unsigned seed = 2024;
+	for (long k = 0; k < N_QUERIES; k++) {
+		for (int j = 0; j < 4; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			int next = q[j] + (int)((seed >> 16) % 5) - 2;
+			q[j] = next < -45 ? -45 : (next > 45 ? 45 : next);
+			thetas[k * 4 + j] = q[j] * DEG;
+		}
+	}
+	return thetas;
+}
+
+// Cached results against FK of the snapped angles
+static bool checkCache(const kinematics::RobotModel &model, kinematics::FkCache &cache, const std::vector<float> &thetas) {
+	for (long k = 0; k < 4096; k++) {
+		// Off-grid by less than half a step, so it snaps back to the same degree
+		float q[4], snapped[4];
+		for (int j = 0; j < 4; j++) {
+			snapped[j] = lrintf(thetas[k * 4 + j] / cache.step()) * cache.step();
+			q[j] = thetas[k * 4 + j] + 0.3f * cache.step();
+		}
+		linalg::Transform cached, ref;
+		cache.fk(q, cached);
+		kinematics::forwardKinematics(model, snapped, ref);
+		if (memcmp(&cached, &ref, sizeof(ref)) != 0) {
+			return false;
+		}
+	}
+	cache.clear();
+	return true;
+}
+
+// Hit rate and lookup cost for a range of capacities
+static void BM_FkCache(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::FkCache cache(model, state.range(0));
+	std::vector<float> thetas = makeQueries();
+	if (!checkCache(model, cache, thetas)) {
+		state.SkipWithError("cached transform differs from FK at the snapped angles");
+		return;
+	}
+	long k = 0;
+	linalg::Transform T;
+	for (auto _ : state) {
+		cache.fk(&thetas[(k % N_QUERIES) * 4], T);
+		benchmark::DoNotOptimize(T);
+		k++;
+	}
+	kinematics::FkCacheStats st = cache.stats();
+	state.counters["hit_rate"] = cache.hitRate();
+	state.counters["evictions"] = (double)st.evictions / (st.hits + st.misses);
+	state.counters["fill"] = (double)st.entries / cache.capacity();
+}
+BENCHMARK(BM_FkCache)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+
+// Hit-only latency: a warm cache answering the first range(0) queries, which it holds,
+// to set against BM_FkCacheUncached. A small working set stays in L2, the full one does not.
+static void BM_FkCacheHit(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const long n = state.range(0);
+	kinematics::FkCache cache(model, 4 * n);
+	std::vector<float> thetas = makeQueries();
+	linalg::Transform T;
+	for (long k = 0; k < n; k++) {
+		cache.fk(&thetas[k * 4], T);
+	}
+	cache.resetStats();
+	long k = 0;
+	for (auto _ : state) {
+		cache.lookup(&thetas[(k % n) * 4], T);
+		benchmark::DoNotOptimize(T);
+		k++;
+	}
+	state.counters["hit_rate"] = cache.hitRate();
+}
+BENCHMARK(BM_FkCacheHit)->Arg(1 << 10)->Arg(N_QUERIES);
+
+// The same queries without a cache
+static void BM_FkCacheUncached(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	std::vector<float> thetas = makeQueries();
+	long k = 0;
+	linalg::Transform T;
+	for (auto _ : state) {
+		kinematics::forwardKinematics(model, &thetas[(k % N_QUERIES) * 4], T);
+		benchmark::DoNotOptimize(T);
+		k++;
+	}
+}
+BENCHMARK(BM_FkCacheUncached);
+
+// Threads sharing one warm cache
+static void BM_FkCacheShared(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::FkCache cache(model, 1 << 18);
+	std::vector<float> thetas = makeQueries();
+	linalg::Transform T;
+	for (long k = 0; k < N_QUERIES; k++) {
+		cache.fk(&thetas[k * 4], T);
+	}
+	cache.resetStats();
+	omp_set_num_threads(state.range(0));
+	for (auto _ : state) {
+		#pragma omp parallel for schedule(static)
+		for (long k = 0; k < N_QUERIES; k++) {
+			linalg::Transform out;
+			cache.fk(&thetas[k * 4], out);
+			benchmark::DoNotOptimize(out);
+		}
+	}
+	omp_set_num_threads(omp_get_num_procs());
+	state.counters["hit_rate"] = cache.hitRate();
+	state.counters["lookups/s"] = benchmark::Counter(state.iterations() * N_QUERIES, benchmark::Counter::kIsRate);
+}
+static void threadCounts(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int t = 1; t < n_procs; t *= 2) {
+		b->Arg(t);
+	}
+	b->Arg(n_procs);
+}
+BENCHMARK(BM_FkCacheShared)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include "kinematics/fk.h"
+#include "kinematics/fk_scan.h"
+
+// Modular arm of n joints: axes cycle through z, x, y, one 10 mm link between joints
+static kinematics::RobotModel makeLongChain(int n) {
+	kinematics::JointSpec joints[kinematics::MAX_JOINTS];
+	const linalg::Vec3 axes[3] = {{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}};
+	for (int i = 0; i < n; i++) {
+		joints[i] = kinematics::JointSpec{axes[i % 3], {0.0f, 0.0f, 10.0f * i}};
+	}
+	linalg::Transform M = linalg::transformIdentity<float>();
+	M.p = linalg::Vec3{0.0f, 0.0f, 10.0f * n};
+	return kinematics::RobotModel(joints, n, M);
+}
+
+static void fillThetas(float *thetas, int n) {
+	for (int i = 0; i < n; i++) {
+		thetas[i] = 0.3f * sinf(0.7f * i + 0.1f);
+	}
+}
+
+// Position error of out against forwardKinematics and of every frame against the sequential frames
+static bool matchesReference(const kinematics::RobotModel &model, const float *thetas,
+			     const linalg::Transform *frames, const linalg::Transform &out) {
+	const int n = model.nJoints();
+	linalg::Transform ref_frames[kinematics::MAX_JOINTS], ref;
+	kinematics::fkLinkFrames(model, thetas, ref_frames, ref);
+	float tolerance = 1e-5f * 10.0f * n;
+	bool ok = linalg::norm(ref.p - out.p) < tolerance;
+	for (int i = 0; frames != nullptr && i < n; i++) {
+		ok = ok && linalg::norm(ref_frames[i].p - frames[i].p) < tolerance;
+	}
+	linalg::Transform fk;
+	kinematics::forwardKinematics(model, thetas, fk);
+	return ok && linalg::norm(ref.p - fk.p) < tolerance;
+}
+
+static void BM_FkLinkFramesSequential(benchmark::State &state) {
+	int n = state.range(0);
+	kinematics::RobotModel model = makeLongChain(n);
+	float thetas[kinematics::MAX_JOINTS];
+	fillThetas(thetas, n);
+	linalg::Transform frames[kinematics::MAX_JOINTS], T;
+	for (auto _ : state) {
+		kinematics::fkLinkFrames(model, thetas, frames, T);
+		benchmark::DoNotOptimize(frames);
+		thetas[0] += 1e-6f;
+	}
+}
+BENCHMARK(BM_FkLinkFramesSequential)->RangeMultiplier(2)->Range(4, 64);
+
+// Latency of the threaded scan against chain length and thread count
+static void BM_FkScan(benchmark::State &state) {
+	int n = state.range(0);
+	int n_threads = state.range(1);
+	kinematics::RobotModel model = makeLongChain(n);
+	float thetas[kinematics::MAX_JOINTS];
+	fillThetas(thetas, n);
+	linalg::Transform frames[kinematics::MAX_JOINTS], T;
+	kinematics::fkScan(model, thetas, frames, T, n_threads);
+	if (!matchesReference(model, thetas, frames, T)) {
+		state.SkipWithError("fkScan disagrees with the sequential product");
+	}
+	for (auto _ : state) {
+		kinematics::fkScan(model, thetas, frames, T, n_threads);
+		benchmark::DoNotOptimize(frames);
+		thetas[0] += 1e-6f;
+	}
+	state.counters["threads"] = n_threads;
+}
+// Chain lengths 4..64 crossed with 1, 2, 4, ... up to the number of cores
+static void chainLengthsAndThreads(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int n = 4; n <= 64; n *= 2) {
+		for (int t = 1; t < n_procs; t *= 2) {
+			b->Args({n, t});
+		}
+		b->Args({n, n_procs});
+	}
+}
+BENCHMARK(BM_FkScan)->Apply(chainLengthsAndThreads)->UseRealTime();
+
+static void BM_FkTreeReduce(benchmark::State &state) {
+	int n = state.range(0);
+	kinematics::RobotModel model = makeLongChain(n);
+	float thetas[kinematics::MAX_JOINTS];
+	fillThetas(thetas, n);
+	linalg::Transform T;
+	kinematics::fkTreeReduce(model, thetas, T);
+	if (!matchesReference(model, thetas, nullptr, T)) {
+		state.SkipWithError("fkTreeReduce disagrees with the sequential product");
+	}
+	for (auto _ : state) {
+		kinematics::fkTreeReduce(model, thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+}
+BENCHMARK(BM_FkTreeReduce)->RangeMultiplier(2)->Range(4, 64);
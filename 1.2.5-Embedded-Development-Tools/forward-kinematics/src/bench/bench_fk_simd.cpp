@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/fk_simd.h"
+
+static const int N_BLOCKS = 1024;
+
+// Same configurations stored SoA for the lane kernel and AoS for the scalar path
+static void makeConfigs(int n_joints, float *soa, float *aos) {
+	for (int b = 0; b < N_BLOCKS; b++) {
+		for (int j = 0; j < n_joints; j++) {
+			for (int l = 0; l < kinematics::FK_LANES; l++) {
+				float theta = 0.001f * (b * kinematics::FK_LANES + l) + 0.3f * j;
+				soa[(b * n_joints + j) * kinematics::FK_LANES + l] = theta;
+				aos[(b * kinematics::FK_LANES + l) * n_joints + j] = theta;
+			}
+		}
+	}
+}
+
+static void BM_FkScalar(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const int n = N_BLOCKS * kinematics::FK_LANES;
+	float *soa = new float[n * arm.N_JOINTS];
+	float *aos = new float[n * arm.N_JOINTS];
+	linalg::Transform *poses = new linalg::Transform[n];
+	makeConfigs(arm.N_JOINTS, soa, aos);
+
+	for (auto _ : state) {
+		for (int i = 0; i < n; i++) {
+			kinematics::forwardKinematics(model, aos + i * arm.N_JOINTS, poses[i]);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+	delete[] soa;
+	delete[] aos;
+	delete[] poses;
+}
+BENCHMARK(BM_FkScalar);
+
+static void BM_FkLanes(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const int n = N_BLOCKS * kinematics::FK_LANES;
+	float *soa = new float[n * arm.N_JOINTS];
+	float *aos = new float[n * arm.N_JOINTS];
+	kinematics::TransformBatch *poses = new kinematics::TransformBatch[N_BLOCKS];
+	makeConfigs(arm.N_JOINTS, soa, aos);
+
+	// Polynomial sin/cos of the lanes against libm over several turns
+	for (int k = -100000; k <= 100000; k++) {
+		float x = k * 2e-4f, s, c;
+		kinematics::sinCosLanes(x, s, c);
+		if (fabsf(s - sinf(x)) > 3e-7f || fabsf(c - cosf(x)) > 3e-7f) {
+			state.SkipWithError("sinCosLanes disagrees with sinf/cosf");
+			break;
+		}
+	}
+	// Cross-check one block against the scalar path before timing
+	kinematics::fkLanes(model, soa, poses[0]);
+	for (int l = 0; l < kinematics::FK_LANES; l++) {
+		linalg::Transform ref, lane = kinematics::extractLane(poses[0], l);
+		kinematics::forwardKinematics(model, aos + l * arm.N_JOINTS, ref);
+		if (linalg::norm(ref.p - lane.p) > 1e-3f) {
+			state.SkipWithError("fkLanes disagrees with forwardKinematics");
+		}
+	}
+
+	for (auto _ : state) {
+		for (int b = 0; b < N_BLOCKS; b++) {
+			kinematics::fkLanes(model, soa + b * arm.N_JOINTS * kinematics::FK_LANES, poses[b]);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+	state.counters["lanes"] = kinematics::FK_LANES;
+	delete[] soa;
+	delete[] aos;
+	delete[] poses;
+}
+BENCHMARK(BM_FkLanes);
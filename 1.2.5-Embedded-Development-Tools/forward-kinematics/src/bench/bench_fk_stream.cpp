@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <string>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/fk_stream.h"
+
+static const long N_SAMPLES = 1 << 18;
+
+// Binary trajectory file shared by the benchmarks, written once
+static std::string trajectoryPath() {
+	static std::string path;
+	if (path.empty()) {
+		path = std::string(FK_BENCH_DIR) + "/trajectory.f32";
+		FILE *f = fopen(path.c_str(), "wb");
+		for (long i = 0; i < N_SAMPLES; i++) {
+			float q[4] = {0.001f * (i % 6283), 0.5f * sinf(0.01f * i), 0.3f * cosf(0.02f * i), 0.0005f * (i % 1000)};
+			fwrite(q, sizeof(q), 1, f);
+		}
+		fclose(f);
+	}
+	return path;
+}
+
+// Reads the binary output back and checks every pose, in order, against forwardKinematics
+static bool outputMatches(const kinematics::RobotModel &model, FILE *in, FILE *out) {
+	rewind(in);
+	rewind(out);
+	float q[4];
+	linalg::Transform got, want;
+	long n = 0;
+	while (fread(q, sizeof(q), 1, in) == 1) {
+		if (fread(&got, sizeof(got), 1, out) != 1) {
+			return false;
+		}
+		kinematics::forwardKinematics(model, q, want);
+		if (linalg::norm(got.p - want.p) > 1e-4f) {
+			return false;
+		}
+		n++;
+	}
+	return n == N_SAMPLES && fread(&got, sizeof(got), 1, out) == 0;
+}
+
+// End-to-end samples per second, text (0) or binary (1) output, discarded to /dev/null
+static void BM_FkStream(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::StreamOptions options;
+	options.input_format = kinematics::STREAM_BINARY;
+	options.output_format = state.range(0) ? kinematics::STREAM_BINARY : kinematics::STREAM_TEXT;
+
+	std::string input = trajectoryPath();
+	FILE *in = fopen(input.c_str(), "rb");
+	FILE *check = tmpfile();
+	kinematics::StreamOptions check_options = options;
+	check_options.output_format = kinematics::STREAM_BINARY;
+	// Small chunks and several workers so chunks really finish out of order
+	check_options.chunk_samples = 1000;
+	check_options.fk_threads = 4;
+	kinematics::runFkStream(model, in, check, check_options);
+	if (!outputMatches(model, in, check)) {
+		state.SkipWithError("stream output is missing, reordered or wrong");
+	}
+	fclose(check);
+	fclose(in);
+
+	FILE *sink = fopen("/dev/null", "w");
+	double rate = 0;
+	for (auto _ : state) {
+		in = fopen(input.c_str(), "rb");
+		kinematics::StreamStats stats = kinematics::runFkStream(model, in, sink, options);
+		fclose(in);
+		rate = stats.samples_per_second;
+	}
+	fclose(sink);
+	state.SetItemsProcessed(state.iterations() * N_SAMPLES);
+	state.counters["samples_per_s"] = rate;
+}
+BENCHMARK(BM_FkStream)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "alloc_counter.h"
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/ik.h"
+#include "kinematics/analytic_ik.h"
+
+static const int N_TARGETS = 256;
+
+// Smooth joint-space path, turned into pose targets with FK
+static void makePath(const kinematics::RobotModel &model, linalg::Transform *targets) {
+	for (int k = 0; k < N_TARGETS; k++) {
+		float t = (float)k / N_TARGETS;
+		float thetas[4] = {1.2f * sinf(2 * M_PI * t), 0.4f + 0.3f * sinf(4 * M_PI * t),
+				   0.8f - 0.5f * t, -0.3f + 0.6f * t};
+		kinematics::forwardKinematics(model, thetas, targets[k]);
+	}
+}
+
+// Tracks the path with warm starts, as a control loop would
+static void BM_IkTracking(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform targets[N_TARGETS];
+	makePath(model, targets);
+	kinematics::IkSolver solver(model);
+	float start[4] = {0.0f, 0.4f, 0.8f, -0.3f};
+	solver.seed(start);
+
+	float thetas[4];
+	long iterations = 0, failures = 0, worst_ns = 0, solves = 0;
+	size_t allocs_before = bench::allocationCount();
+	for (auto _ : state) {
+		kinematics::IkResult r = solver.solve(targets[solves % N_TARGETS], thetas);
+		iterations += r.iterations;
+		failures += !r.converged;
+		worst_ns = r.time_ns > worst_ns ? r.time_ns : worst_ns;
+		solves++;
+	}
+	size_t allocs = bench::allocationCount() - allocs_before;
+	if (allocs != 0) {
+		state.SkipWithError("IkSolver allocated memory");
+	}
+	state.counters["iters/solve"] = (double)iterations / solves;
+	state.counters["failures"] = failures;
+	state.counters["worst_us"] = worst_ns * 1e-3;
+}
+BENCHMARK(BM_IkTracking);
+
+// Random reachable targets, solved from a fixed cold start
+static void makeRandomTargets(const kinematics::RobotModel &model, linalg::Transform *targets) {
+	unsigned seed = 12345;
+	for (int k = 0; k < N_TARGETS; k++) {
+		float thetas[4];
+		for (int i = 0; i < 4; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			thetas[i] = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * 2.5f;
+		}
+		kinematics::forwardKinematics(model, thetas, targets[k]);
+	}
+}
+
+static void BM_IkNumericalColdStart(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform targets[N_TARGETS];
+	makeRandomTargets(model, targets);
+	kinematics::IkSolver solver(model);
+	const float start[4] = {0.1f, 0.1f, 0.1f, 0.1f};
+	float thetas[4];
+	long failures = 0, solves = 0;
+	for (auto _ : state) {
+		solver.seed(start);
+		kinematics::IkResult r = solver.solve(targets[solves % N_TARGETS], thetas);
+		failures += !r.converged;
+		solves++;
+	}
+	state.counters["failure_rate"] = (double)failures / solves;
+}
+BENCHMARK(BM_IkNumericalColdStart);
+
+static void BM_IkAnalytic(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform targets[N_TARGETS];
+	makeRandomTargets(model, targets);
+	kinematics::AnalyticIk4 ik(arm, model);
+	kinematics::AnalyticIkSolutions solutions;
+	long failures = 0, solves = 0;
+	for (auto _ : state) {
+		ik.solve(targets[solves % N_TARGETS], solutions);
+		failures += solutions.count == 0;
+		solves++;
+	}
+	state.counters["failure_rate"] = (double)failures / solves;
+}
+BENCHMARK(BM_IkAnalytic);
+
+static void BM_IkAnalyticBatch(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	linalg::Transform targets[N_TARGETS];
+	kinematics::AnalyticIkSolutions solutions[N_TARGETS];
+	makeRandomTargets(model, targets);
+	kinematics::AnalyticIk4 ik(arm, model);
+	for (auto _ : state) {
+		ik.solveBatch(targets, solutions, N_TARGETS);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * N_TARGETS);
+}
+BENCHMARK(BM_IkAnalyticBatch);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/incremental_fk.h"
+
+// Servo-style motion: each tick moves only the joint given by the argument
+static void BM_IncrementalFk(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::IncrementalFk fk(model);
+	int moving = state.range(0);
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T, ref;
+
+	for (auto _ : state) {
+		// Sweep back and forth within joint range like the servo loop
+		thetas[moving] = (thetas[moving] > 3.0f) ? -3.0f : thetas[moving] + 0.01f;
+		fk.update(thetas, T);
+		benchmark::DoNotOptimize(T);
+	}
+
+	kinematics::forwardKinematics(model, thetas, ref);
+	if (linalg::norm(ref.p - T.p) > 1e-3f) {
+		state.SkipWithError("IncrementalFk disagrees with forwardKinematics");
+	}
+	state.counters["hit_rate"] = fk.hitRate();
+	state.counters["suffix_updates"] = fk.stats().suffix_updates;
+	state.counters["flops_saved/update"] = (double)fk.stats().flops_saved / fk.stats().updates;
+}
+BENCHMARK(BM_IncrementalFk)->DenseRange(0, 3);
+
+static void BM_ForwardKinematicsBody(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T, ref;
+
+	kinematics::forwardKinematics(model, thetas, ref);
+	kinematics::forwardKinematicsBody(model, thetas, T);
+	if (linalg::norm(ref.p - T.p) > 1e-3f) {
+		state.SkipWithError("body and space forms disagree");
+	}
+	for (auto _ : state) {
+		kinematics::forwardKinematicsBody(model, thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+}
+BENCHMARK(BM_ForwardKinematicsBody);
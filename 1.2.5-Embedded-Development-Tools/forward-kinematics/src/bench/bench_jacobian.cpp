@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/jacobian.h"
+
+// Finite-difference check of the space Jacobian on the end-effector position:
+// dp/dtheta_i = w_i x p + v_i for column i = (w_i, v_i)
+static float jacobianError(const kinematics::RobotModel &model, const float *thetas, const kinematics::Twist *J) {
+	const float h = 1e-3f;
+	float worst = 0;
+	linalg::Transform T0, T1;
+	kinematics::forwardKinematics(model, thetas, T0);
+	for (int i = 0; i < model.nJoints(); i++) {
+		float perturbed[kinematics::MAX_JOINTS];
+		for (int j = 0; j < model.nJoints(); j++) {
+			perturbed[j] = thetas[j];
+		}
+		perturbed[i] += h;
+		kinematics::forwardKinematics(model, perturbed, T1);
+		linalg::Vec3 dp = (T1.p - T0.p) * (1.0f / h);
+		linalg::Vec3 expected = linalg::cross(J[i].w, T0.p) + J[i].v;
+		float err = linalg::norm(dp - expected);
+		worst = err > worst ? err : worst;
+	}
+	return worst;
+}
+
+// Compare against BM_ForwardKinematics/threads:1 for the cost of FK alone
+static void BM_FkWithJacobian(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T;
+	kinematics::Twist J[4];
+
+	kinematics::fkWithJacobian(model, thetas, T, J);
+	if (jacobianError(model, thetas, J) > 0.5f) {
+		state.SkipWithError("space Jacobian disagrees with finite differences");
+	}
+	for (auto _ : state) {
+		kinematics::fkWithJacobian(model, thetas, T, J);
+		benchmark::DoNotOptimize(T);
+		benchmark::DoNotOptimize(J);
+		thetas[0] += 1e-6f;
+	}
+}
+BENCHMARK(BM_FkWithJacobian);
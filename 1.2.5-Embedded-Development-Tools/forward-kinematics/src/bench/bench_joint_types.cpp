@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/joint_types.h"
+
+static float maxDifference(const linalg::Transform &a, const linalg::Transform &b) {
+	float worst = linalg::norm(a.p - b.p);
+	for (int k = 0; k < 9; k++) {
+		worst = fmaxf(worst, fabsf(a.R.m[k] - b.R.m[k]));
+	}
+	return worst;
+}
+
+static void BM_FkJointChain(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::CourseArmChain chain = kinematics::makeCourseArmChain(arm);
+	float worst = 0;
+	for (int k = 0; k < 1000; k++) {
+		float q[4] = {0.013f * k - 6.0f, 0.7f - 0.002f * k, 0.005f * k, 2.0f - 0.004f * k};
+		linalg::Transform ref, T;
+		kinematics::forwardKinematics(model, q, ref);
+		chain.fk(q, T);
+		worst = fmaxf(worst, maxDifference(ref, T));
+	}
+	if (worst > 1e-3f) {
+		state.SkipWithError("JointChain disagrees with forwardKinematics");
+	}
+
+	float thetas[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+	linalg::Transform T;
+	for (auto _ : state) {
+		chain.fk(thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+	state.counters["max_error"] = worst;
+}
+BENCHMARK(BM_FkJointChain);
+
+// Every joint type in one chain, checked against composing the dense exponentials
+static void BM_FkJointChainMixed(benchmark::State &state) {
+	linalg::Vec3 general_axis = linalg::normalize(linalg::Vec3{1.0f, 1.0f, 0.0f});
+	kinematics::JointSpec general_spec{general_axis, {0.0f, 20.0f, 50.0f}};
+	linalg::Vec3 slide = linalg::normalize(linalg::Vec3{0.0f, 0.6f, 0.8f});
+	linalg::Transform M = linalg::transformIdentity<float>();
+	M.p = linalg::Vec3{0.0f, 0.0f, 40.0f};
+	kinematics::JointChain<kinematics::RevoluteZ, kinematics::Prismatic, kinematics::RevoluteY,
+			       kinematics::RevoluteGeneral, kinematics::RevoluteX>
+		chain(M, kinematics::RevoluteZ{{5.0f, 0.0f, 0.0f}}, kinematics::Prismatic{slide},
+		      kinematics::RevoluteY{{0.0f, 0.0f, 30.0f}}, kinematics::RevoluteGeneral::fromSpec(general_spec, 3),
+		      kinematics::RevoluteX{{0.0f, 10.0f, 70.0f}});
+
+	const kinematics::JointSpec revolute_specs[3] = {{{0.0f, 0.0f, 1.0f}, {5.0f, 0.0f, 0.0f}},
+							  {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 30.0f}},
+							  {{1.0f, 0.0f, 0.0f}, {0.0f, 10.0f, 70.0f}}};
+	float worst = 0;
+	for (int k = 0; k < 1000; k++) {
+		float q[5] = {0.01f * k - 5.0f, 0.1f * k - 50.0f, 0.003f * k, 1.0f - 0.004f * k, 0.006f * k - 3.0f};
+		linalg::Transform E[5], ref, T;
+		expScrew(kinematics::makeScrew(revolute_specs[0]), q[0], E[0]);
+		E[1] = linalg::Transform{linalg::mat3Identity<float>(), slide * q[1]};
+		expScrew(kinematics::makeScrew(revolute_specs[1]), q[2], E[2]);
+		expScrew(kinematics::makeScrew(general_spec), q[3], E[3]);
+		expScrew(kinematics::makeScrew(revolute_specs[2]), q[4], E[4]);
+		ref = E[0];
+		for (int i = 1; i < 5; i++) {
+			ref = linalg::compose(ref, E[i]);
+		}
+		ref = linalg::compose(ref, M);
+		chain.fk(q, T);
+		worst = fmaxf(worst, maxDifference(ref, T));
+	}
+	if (worst > 1e-3f) {
+		state.SkipWithError("mixed JointChain disagrees with the dense exponentials");
+	}
+
+	float thetas[5] = {0.1f, 12.0f, 0.3f, 0.4f, 0.5f};
+	linalg::Transform T;
+	for (auto _ : state) {
+		chain.fk(thetas, T);
+		benchmark::DoNotOptimize(T);
+		thetas[0] += 1e-6f;
+	}
+	state.counters["max_error"] = worst;
+}
+BENCHMARK(BM_FkJointChainMixed);
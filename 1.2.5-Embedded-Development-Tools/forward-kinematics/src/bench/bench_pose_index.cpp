@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/pose_index.h"
+
+static const int N_TARGETS = 1024;
+static const long N_ENTRIES = 1 << 18;
+
+// Reachable targets from joint angles the index did not sample
+static void makeTargets(const kinematics::RobotModel &model, linalg::Transform *targets) {
+	unsigned seed = 777;
+	for (int k = 0; k < N_TARGETS; k++) {
+		float thetas[4];
+		for (int i = 0; i < 4; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			thetas[i] = ((seed >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f) * 2.5f;
+		}
+		kinematics::forwardKinematics(model, thetas, targets[k]);
+	}
+}
+
+// Index of the course arm, built once and saved, then mapped back like at startup
+static const kinematics::PoseIndex &courseArmIndex(const kinematics::RobotModel &model) {
+	static kinematics::PoseIndex index;
+	if (index.size() == 0) {
+		std::string path = std::string(FK_BENCH_DIR) + "/pose_index.bin";
+		kinematics::PoseIndex built;
+		kinematics::WorkspaceSamplingOptions sampling;
+		sampling.samples = N_ENTRIES;
+		built.build(model, sampling);
+		if (built.write(path.c_str())) {
+			index.map(path.c_str(), model);
+		}
+	}
+	return index;
+}
+
+// Squared key distance with the default PoseIndexOptions, recomputed from the entry's joint angles
+static float keyDistance2(const kinematics::RobotModel &model, const float *thetas, const linalg::Transform &target) {
+	const float w = kinematics::PoseIndexOptions().orientation_weight;
+	linalg::Transform T;
+	kinematics::forwardKinematics(model, thetas, T);
+	linalg::Vec3 dp = T.p - target.p;
+	float d2 = linalg::dot(dp, dp);
+	for (int k = 0; k < 9; k++) {
+		if (k % 3 != 1) {
+			float d = w * (T.R.m[k] - target.R.m[k]);
+			d2 += d * d;
+		}
+	}
+	return d2;
+}
+
+// Latency of k-nearest queries on the mapped index, checked against a linear scan
+static void BM_PoseIndexNearest(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const kinematics::PoseIndex &index = courseArmIndex(model);
+	if (index.size() != N_ENTRIES) {
+		state.SkipWithError("cannot build, save or map the pose index");
+		return;
+	}
+	linalg::Transform targets[N_TARGETS];
+	makeTargets(model, targets);
+	int k = state.range(0);
+
+	long ids[kinematics::MAX_NEIGHBOURS];
+	float dist2[kinematics::MAX_NEIGHBOURS];
+	for (int t = 0; t < 8; t++) {
+		float brute = 3.4e38f;
+		for (long i = 0; i < index.size(); i++) {
+			float d2 = keyDistance2(model, index.thetas(i), targets[t]);
+			brute = d2 < brute ? d2 : brute;
+		}
+		int found = index.nearest(targets[t], k, ids, dist2);
+		if (found != k || fabsf(dist2[0] - brute) > 1e-3f * (1.0f + brute)) {
+			state.SkipWithError("tree search missed the nearest entry");
+		}
+	}
+
+	long queries = 0;
+	for (auto _ : state) {
+		int found = index.nearest(targets[queries % N_TARGETS], k, ids, dist2);
+		benchmark::DoNotOptimize(found);
+		queries++;
+	}
+	state.counters["entries"] = index.size();
+}
+BENCHMARK(BM_PoseIndexNearest)->Arg(1)->Arg(4)->Arg(16);
+
+// Startup cost of an index: open, mmap and check the header
+static void BM_PoseIndexMap(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	if (courseArmIndex(model).size() == 0) {
+		state.SkipWithError("cannot build the pose index");
+		return;
+	}
+	std::string path = std::string(FK_BENCH_DIR) + "/pose_index.bin";
+	for (auto _ : state) {
+		kinematics::PoseIndex index;
+		if (!index.map(path.c_str(), model)) {
+			state.SkipWithError("cannot map the pose index");
+			break;
+		}
+		benchmark::DoNotOptimize(index.size());
+	}
+}
+BENCHMARK(BM_PoseIndexMap);
+
+// Cold-start numerical IK seeded from the index, against BM_IkNumericalColdStart's fixed seed
+static void BM_IkIndexSeeded(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const kinematics::PoseIndex &index = courseArmIndex(model);
+	if (index.size() == 0) {
+		state.SkipWithError("cannot build the pose index");
+		return;
+	}
+	linalg::Transform targets[N_TARGETS];
+	makeTargets(model, targets);
+	kinematics::IkSolver solver(model);
+	float thetas[4];
+	long failures = 0, solves = 0, iterations = 0;
+	for (auto _ : state) {
+		kinematics::IkResult r = kinematics::solveFromIndex(index, solver, targets[solves % N_TARGETS], thetas);
+		failures += !r.converged;
+		iterations += r.iterations;
+		solves++;
+	}
+	state.counters["failure_rate"] = (double)failures / solves;
+	state.counters["iterations"] = (double)iterations / solves;
+}
+BENCHMARK(BM_IkIndexSeeded);
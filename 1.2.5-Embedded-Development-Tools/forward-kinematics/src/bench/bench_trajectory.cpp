@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk_batch.h"
+#include "kinematics/servo.h"
+#include "kinematics/trajectory.h"
+
+static const int N_WAYPOINTS = 6;
+// Servo-like limits, rad/s and rad/s^2
+static const float MAX_VELOCITY[4] = {4.0f, 3.0f, 3.0f, 5.0f};
+static const float MAX_ACCELERATION[4] = {20.0f, 12.0f, 12.0f, 30.0f};
+static const float PERIOD = 1e-3f;
+
+// Pick-and-place style path of the course arm
+static kinematics::Trajectory makeTrajectory(const kinematics::RobotModel &model, kinematics::TrajectoryProfile profile) {
+	const float waypoints[N_WAYPOINTS * 4] = {
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.8f, 0.6f, 0.9f, 0.5f,
+		0.8f, 0.9f, 1.2f, 0.4f,
+		-0.6f, 0.4f, 0.7f, 0.5f,
+		-0.6f, 0.4f, 0.7f, 0.5f,
+		0.0f, 0.0f, 0.0f, 0.0f};
+	return kinematics::Trajectory(model, waypoints, N_WAYPOINTS, profile, MAX_VELOCITY, MAX_ACCELERATION);
+}
+
+// Batched samples against sample(), limits along the whole path, and arrival at each waypoint
+static bool checkTrajectory(const kinematics::Trajectory &traj) {
+	long n = traj.samplesAtPeriod(PERIOD);
+	std::vector<float> q(n * 4), qd(n * 4);
+	traj.sampleUniform(0.0f, PERIOD, n, q.data(), qd.data());
+	for (long k = 0; k < n; k++) {
+		float p[4], v[4], a[4];
+		traj.sample(k * PERIOD, p, v, a);
+		for (int j = 0; j < 4; j++) {
+			if (fabsf(p[j] - q[k * 4 + j]) > 1e-5f || fabsf(v[j] - qd[k * 4 + j]) > 1e-4f ||
+			    fabsf(v[j]) > MAX_VELOCITY[j] * 1.001f || fabsf(a[j]) > MAX_ACCELERATION[j] * 1.001f) {
+				return false;
+			}
+		}
+	}
+	float start[4], end[4];
+	traj.sample(traj.waypointTime(1), start);
+	traj.sample(traj.duration(), end);
+	return fabsf(start[1] - 0.6f) < 1e-5f && fabsf(end[2]) < 1e-5f;
+}
+
+static const char *profileName(int profile) {
+	static const char *names[] = {"cubic", "quintic", "trapezoid"};
+	return names[profile];
+}
+
+// Joint samples at 1 kHz over the whole trajectory
+static void BM_TrajectorySampleUniform(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::Trajectory traj = makeTrajectory(model, (kinematics::TrajectoryProfile)state.range(0));
+	if (!checkTrajectory(traj)) {
+		state.SkipWithError("trajectory breaks its limits or disagrees with sample()");
+		return;
+	}
+	long n = traj.samplesAtPeriod(PERIOD);
+	std::vector<float> q(n * 4);
+	for (auto _ : state) {
+		traj.sampleUniform(0.0f, PERIOD, n, q.data());
+		benchmark::DoNotOptimize(q.data());
+	}
+	state.SetLabel(profileName(state.range(0)));
+	state.counters["duration_s"] = traj.duration();
+	state.counters["samples/s"] = benchmark::Counter(state.iterations() * n, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TrajectorySampleUniform)->DenseRange(0, 2);
+
+// The same samples one sample() call at a time
+static void BM_TrajectorySampleScalar(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::Trajectory traj = makeTrajectory(model, (kinematics::TrajectoryProfile)state.range(0));
+	long n = traj.samplesAtPeriod(PERIOD);
+	std::vector<float> q(n * 4);
+	for (auto _ : state) {
+		for (long k = 0; k < n; k++) {
+			traj.sample(k * PERIOD, &q[k * 4]);
+		}
+		benchmark::DoNotOptimize(q.data());
+	}
+	state.SetLabel(profileName(state.range(0)));
+	state.counters["samples/s"] = benchmark::Counter(state.iterations() * n, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TrajectorySampleScalar)->DenseRange(0, 2);
+
+// Samples at the servo rate, their end-effector poses and the driver's pulse widths
+static void BM_TrajectoryToServo(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::Trajectory traj = makeTrajectory(model, kinematics::PROFILE_QUINTIC);
+	const float servo_period = kinematics::SERVO_PERIOD_US * 1e-6f;
+	long n = traj.samplesAtPeriod(servo_period);
+	std::vector<float> q(n * 4);
+	std::vector<uint16_t> pulses(n * 4);
+	linalg::Transform *poses = (linalg::Transform *)kinematics::allocBatchBuffer(n, sizeof(linalg::Transform));
+	kinematics::ServoCalibration cal[4];
+	for (auto _ : state) {
+		traj.sampleUniform(0.0f, servo_period, n, q.data());
+		kinematics::fkBatch(model, q.data(), poses, n);
+		kinematics::servoPulses(q.data(), n, 4, cal, pulses.data());
+		benchmark::DoNotOptimize(pulses.data());
+	}
+	// Home is 90 degrees on every servo, 90 * 11 + 500 us
+	if (pulses[0] != 1490 || pulses[(n - 1) * 4] != 1490 || kinematics::pca9685Ticks(pulses[0]) != 305) {
+		state.SkipWithError("servo pulse conversion does not match the driver");
+	}
+	kinematics::freeBatchBuffer(poses);
+	state.counters["samples"] = n;
+}
+BENCHMARK(BM_TrajectoryToServo);
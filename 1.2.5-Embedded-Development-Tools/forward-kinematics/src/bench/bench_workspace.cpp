@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <omp.h>
+#include <string>
+#include "kinematics/arm_specs.h"
+#include "kinematics/fk.h"
+#include "kinematics/workspace.h"
+
+static const long N_SAMPLES = 1 << 20;
+
+// Same map whatever the thread count, every sampled pose counted in its voxel
+// and the binary file reads back unchanged
+static bool mapIsConsistent(const kinematics::RobotModel &model, const kinematics::WorkspaceMap &map,
+			    const kinematics::WorkspaceSamplingOptions &options) {
+	kinematics::WorkspaceMap single(map.spec());
+	kinematics::WorkspaceMap loaded;
+	std::string path = std::string(FK_BENCH_DIR) + "/workspace.bin";
+	if (!map.write(path.c_str()) || !loaded.read(path.c_str()) || loaded.nVoxels() != map.nVoxels() ||
+	    loaded.samples() != map.samples()) {
+		return false;
+	}
+	int n_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+	kinematics::sampleWorkspace(model, options, single);
+	omp_set_num_threads(n_threads);
+	long total = 0;
+	for (long v = 0; v < map.nVoxels(); v++) {
+		if (map.hits(v) != single.hits(v) || map.orientations(v) != single.orientations(v) ||
+		    map.hits(v) != loaded.hits(v) || map.orientations(v) != loaded.orientations(v)) {
+			return false;
+		}
+		total += map.hits(v);
+	}
+	linalg::Transform T;
+	const float thetas[4] = {0.3f, -0.4f, 1.1f, 0.2f};
+	kinematics::forwardKinematics(model, thetas, T);
+	long voxel = map.voxelIndex(T.p);
+	return map.outside() == 0 && total == map.samples() && voxel >= 0 && map.hits(voxel) > 0;
+}
+
+// Samples per second against the number of OpenMP threads
+static void BM_SampleWorkspace(benchmark::State &state) {
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	int n_threads = state.range(0);
+	omp_set_num_threads(n_threads);
+	kinematics::WorkspaceSamplingOptions options;
+	options.samples = N_SAMPLES;
+	kinematics::WorkspaceGridSpec spec = kinematics::workspaceBounds(model, 10.0f);
+	kinematics::WorkspaceMap checked(spec);
+	kinematics::sampleWorkspace(model, options, checked);
+	if (!mapIsConsistent(model, checked, options)) {
+		state.SkipWithError("workspace map depends on the thread count, lost samples or did not round-trip");
+	}
+
+	for (auto _ : state) {
+		kinematics::WorkspaceMap map(spec);
+		kinematics::sampleWorkspace(model, options, map);
+		benchmark::DoNotOptimize(map.hits(0));
+	}
+	state.SetItemsProcessed(state.iterations() * N_SAMPLES);
+	state.counters["threads"] = n_threads;
+	omp_set_num_threads(omp_get_num_procs());
+}
+
+static void threadCounts(benchmark::internal::Benchmark *b) {
+	int n_procs = omp_get_num_procs();
+	for (int t = 1; t < n_procs; t *= 2) {
+		b->Arg(t);
+	}
+	b->Arg(n_procs);
+}
+BENCHMARK(BM_SampleWorkspace)->Apply(threadCounts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,161 @@
+#include "analytic_ik.h"
+#include "fk.h"
+#include <cmath>
+#include <time.h>
+
+static long nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static float wrapAngle(float a) {
+	return a - 2.0f * (float)M_PI * floorf((a + (float)M_PI) / (2.0f * (float)M_PI));
+}
+
+kinematics::AnalyticIk4::AnalyticIk4(const RoboticArmSpecs &arm, const RobotModel &model, const IkOptions &options)
+	: model_(&model), options_(options), L1_(arm.L1), L2_(arm.L2), L3_(arm.L3) {
+}
+
+// End-effector point: p = (r sin(t1), -r cos(t1), L1 + L2 cos(t2) + L3 cos(t2 + t3))
+// with the signed reach r = L2 sin(t2) + L3 sin(t2 + t3).
+// Orientation: R = Rz(t1) Rx(t2 + t3 + t4) M_R.
+int kinematics::AnalyticIk4::candidates(const linalg::Transform &target, bool clamp, float thetas[MAX_ANALYTIC_SOLUTIONS][4],
+					 float orientation_error[MAX_ANALYTIC_SOLUTIONS]) const {
+	const linalg::Vec3 &p = target.p;
+	// X = R_d M_R^T = Rz(t1) Rx(phi)
+	linalg::Mat3 X = linalg::mat3Mul(target.R, linalg::mat3Transpose(model_->home().R));
+	float rho = sqrtf(p.x * p.x + p.y * p.y);
+	float yaw;
+	if (rho > 1e-4f) {
+		yaw = atan2f(p.x, -p.y);
+	} else {
+		// Target on the base axis: the position leaves t1 free, take it from the orientation
+		yaw = atan2f(X.m[3], X.m[0]);
+	}
+
+	int count = 0;
+	for (int reach = 0; reach < 2; reach++) {
+		// Reaching backwards flips the sign of r and turns the base by pi
+		float t1 = reach == 0 ? yaw : wrapAngle(yaw + (float)M_PI);
+		float r = reach == 0 ? rho : -rho;
+		float b = p.z - L1_;
+		float D = (r * r + b * b - L2_ * L2_ - L3_ * L3_) / (2.0f * L2_ * L3_);
+		// Small overshoots come from rounding on a fully stretched or folded arm
+		if ((D > 1.0f + 1e-4f || D < -1.0f - 1e-4f) && !clamp) {
+			continue;
+		}
+		D = D > 1.0f ? 1.0f : (D < -1.0f ? -1.0f : D);
+		// Y = Rz(-t1) X should be Rx(phi) with phi = t2 + t3 + t4. Its x axis is fixed,
+		// so the angle between Y's x axis and (1, 0, 0) is the orientation the arm cannot reach.
+		float c1 = cosf(t1), s1 = sinf(t1);
+		float y00 = c1 * X.m[0] + s1 * X.m[3];
+		float y11 = -s1 * X.m[1] + c1 * X.m[4];
+		float y21 = X.m[7];
+		float phi = atan2f(y21, y11);
+		float tilt = acosf(y00 > 1.0f ? 1.0f : (y00 < -1.0f ? -1.0f : y00));
+		for (int elbow = 0; elbow < 2; elbow++) {
+			float t3 = elbow == 0 ? acosf(D) : -acosf(D);
+			float t2 = atan2f(r, b) - atan2f(L3_ * sinf(t3), L2_ + L3_ * cosf(t3));
+			float *t = thetas[count++];
+			t[0] = t1;
+			t[1] = wrapAngle(t2);
+			t[2] = t3;
+			t[3] = wrapAngle(phi - t2 - t3);
+			orientation_error[count - 1] = tilt;
+			if (D == 1.0f || D == -1.0f) {
+				// Straight or folded arm: both elbow branches coincide
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+void kinematics::AnalyticIk4::solve(const linalg::Transform &target, AnalyticIkSolutions &out) const {
+	float thetas[MAX_ANALYTIC_SOLUTIONS][4];
+	float orientation_error[MAX_ANALYTIC_SOLUTIONS];
+	int n = candidates(target, false, thetas, orientation_error);
+	out.count = 0;
+	for (int k = 0; k < n; k++) {
+		// Position is exact by construction; orientation is limited by the 4-DOF structure
+		bool valid = !options_.use_orientation || orientation_error[k] < options_.orientation_tolerance;
+		for (int i = 0; i < 4; i++) {
+			valid = valid && thetas[k][i] >= model_->jointLower(i) && thetas[k][i] <= model_->jointUpper(i);
+		}
+		if (valid) {
+			for (int i = 0; i < 4; i++) {
+				out.thetas[out.count][i] = thetas[k][i];
+			}
+			out.count++;
+		}
+	}
+}
+
+void kinematics::AnalyticIk4::solveBatch(const linalg::Transform *targets, AnalyticIkSolutions *out, long n) const {
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < n; i++) {
+		solve(targets[i], out[i]);
+	}
+}
+
+static float jointDistance(const float *a, const float *b) {
+	float d = 0;
+	for (int i = 0; i < 4; i++) {
+		d += fabsf(a[i] - b[i]);
+	}
+	return d;
+}
+
+kinematics::IkResult kinematics::AnalyticIk4::solveOrFallback(const linalg::Transform &target, IkSolver &solver, float *thetas_out) const {
+	long start = nowNs();
+	const float *previous = solver.lastSolution();
+	AnalyticIkSolutions solutions;
+	solve(target, solutions);
+	if (solutions.count > 0) {
+		int best = 0;
+		for (int k = 1; k < solutions.count; k++) {
+			if (jointDistance(solutions.thetas[k], previous) < jointDistance(solutions.thetas[best], previous)) {
+				best = k;
+			}
+		}
+		for (int i = 0; i < 4; i++) {
+			thetas_out[i] = solutions.thetas[best][i];
+		}
+		solver.seed(thetas_out);
+
+		linalg::Transform T;
+		forwardKinematics(*model_, thetas_out, T);
+		IkResult result;
+		result.converged = true;
+		result.iterations = 0;
+		result.position_error = linalg::norm(T.p - target.p);
+		result.orientation_error = options_.use_orientation ?
+			linalg::norm(linalg::logSO3(linalg::mat3Mul(target.R, linalg::mat3Transpose(T.R)))) : 0.0f;
+		result.time_ns = nowNs() - start;
+		return result;
+	}
+
+	// Unreachable as given: seed the numerical solver with the nearest boundary branch, clamped to the limits
+	float seeds[MAX_ANALYTIC_SOLUTIONS][4];
+	float orientation_error[MAX_ANALYTIC_SOLUTIONS];
+	int n = candidates(target, true, seeds, orientation_error);
+	if (n > 0) {
+		int best = 0;
+		for (int k = 1; k < n; k++) {
+			if (jointDistance(seeds[k], previous) < jointDistance(seeds[best], previous)) {
+				best = k;
+			}
+		}
+		for (int i = 0; i < 4; i++) {
+			float t = seeds[best][i];
+			t = t < model_->jointLower(i) ? model_->jointLower(i) : t;
+			t = t > model_->jointUpper(i) ? model_->jointUpper(i) : t;
+			seeds[best][i] = t;
+		}
+		solver.seed(seeds[best]);
+	}
+	IkResult result = solver.solve(target, thetas_out);
+	result.time_ns = nowNs() - start;
+	return result;
+}
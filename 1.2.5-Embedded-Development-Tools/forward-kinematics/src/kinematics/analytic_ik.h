@@ -0,0 +1,49 @@
+#ifndef __KINEMATICS_ANALYTIC_IK__
+#define __KINEMATICS_ANALYTIC_IK__
+
+#include "arm_specs.h"
+#include "ik.h"
+
+namespace kinematics {
+	// Two base-yaw branches (reach forward or backward) times elbow up/down
+	const int MAX_ANALYTIC_SOLUTIONS = 4;
+
+	typedef struct AnalyticIkSolutions {
+		int count;
+		float thetas[MAX_ANALYTIC_SOLUTIONS][4];
+	} AnalyticIkSolutions;
+
+	// Closed-form IK for the course arm: yaw about z at the base, then three
+	// pitch joints about x at heights L1, L1 + L2, L1 + L2 + L3. The base yaw
+	// fixes the arm plane, the first two pitch joints are a planar 2-link arm
+	// reaching the end-effector point and the last pitch joint takes up the
+	// remaining rotation about x. Constant time per target.
+	class AnalyticIk4 {
+	public:
+		AnalyticIk4(const RoboticArmSpecs &arm, const RobotModel &model, const IkOptions &options = IkOptions());
+
+		// Every branch that reaches the target within the option tolerances and
+		// respects the joint limits; count is 0 when the target is unreachable.
+		void solve(const linalg::Transform &target, AnalyticIkSolutions &out) const;
+		// solve() for n targets, split across OpenMP threads
+		void solveBatch(const linalg::Transform *targets, AnalyticIkSolutions *out, long n) const;
+
+		// Analytic branch closest to the solver's previous solution, falling back to
+		// numerical IK seeded with the nearest reachable approximation when no
+		// branch is valid. The solver is re-seeded with the answer.
+		IkResult solveOrFallback(const linalg::Transform &target, IkSolver &solver, float *thetas_out) const;
+
+	private:
+		// Candidate branches and the part of the target orientation each one misses.
+		// With clamp set, out-of-reach targets are pulled to the workspace boundary.
+		int candidates(const linalg::Transform &target, bool clamp, float thetas[MAX_ANALYTIC_SOLUTIONS][4],
+			       float orientation_error[MAX_ANALYTIC_SOLUTIONS]) const;
+
+		const RobotModel *model_;
+		IkOptions options_;
+		float L1_, L2_, L3_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_ANALYTIC_IK__*/
@@ -0,0 +1,313 @@
+#include "arm_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+
+static_assert(std::is_trivially_copyable<kinematics::Screw>::value && std::is_trivially_copyable<kinematics::LinkInertia>::value,
+	      "the binary cache stores the per-joint arrays as raw bytes");
+
+static const char CACHE_MAGIC[8] = {'F', 'K', 'M', 'O', 'D', 'E', 'L', '\0'};
+static const uint32_t CACHE_VERSION = 3;
+
+// Followed by the home transform and then, for n_joints joints each: screws, body screws,
+// joint specs, lower limits, upper limits and link inertias
+typedef struct CacheHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t n_joints;
+	int64_t source_size;
+	int64_t source_mtime_ns;
+} CacheHeader;
+
+static size_t cacheSize(int n_joints) {
+	return sizeof(CacheHeader) + sizeof(linalg::Transform) +
+	       n_joints * (2 * sizeof(kinematics::Screw) + sizeof(kinematics::JointSpec) + 2 * sizeof(float) + sizeof(kinematics::LinkInertia));
+}
+
+/*===================Text description===================*/
+
+// Pulls numbers out of the description, skipping comments and line breaks
+typedef struct Tokenizer {
+	FILE *file;
+	const char *path;
+	int line;
+} Tokenizer;
+
+static bool nextToken(Tokenizer &tok, char *buf, int size) {
+	int c;
+	// Skip whitespace and comments
+	while ((c = fgetc(tok.file)) != EOF) {
+		if (c == '#') {
+			while ((c = fgetc(tok.file)) != EOF && c != '\n') {
+			}
+		}
+		if (c == '\n') {
+			tok.line++;
+		} else if (c != ' ' && c != '\t' && c != '\r' && c != EOF) {
+			break;
+		}
+	}
+	if (c == EOF) {
+		return false;
+	}
+	int n = 0;
+	do {
+		if (n < size - 1) {
+			buf[n++] = (char)c;
+		}
+	} while ((c = fgetc(tok.file)) != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != '#');
+	if (c != EOF) {
+		ungetc(c, tok.file);
+	}
+	buf[n] = '\0';
+	return true;
+}
+
+static float nextNumber(Tokenizer &tok, const char *what) {
+	char buf[64];
+	char *end;
+	if (!nextToken(tok, buf, sizeof(buf))) {
+		fprintf(stderr, "Error: %s:%d: unexpected end of file while reading %s.\n", tok.path, tok.line, what);
+		exit(EXIT_FAILURE);
+	}
+	float value = strtof(buf, &end);
+	if (*end != '\0') {
+		fprintf(stderr, "Error: %s:%d: expected a number for %s, got '%s'.\n", tok.path, tok.line, what, buf);
+		exit(EXIT_FAILURE);
+	}
+	return value;
+}
+
+// Optional trailing number on the current line (used for joint limits)
+static bool peekNumberOnLine(Tokenizer &tok) {
+	int c;
+	while ((c = fgetc(tok.file)) == ' ' || c == '\t' || c == '\r') {
+	}
+	if (c != EOF) {
+		ungetc(c, tok.file);
+	}
+	return c == '-' || c == '+' || c == '.' || (c >= '0' && c <= '9');
+}
+
+kinematics::RobotModel kinematics::parseArmDescription(const char *path) {
+	Tokenizer tok{fopen(path, "r"), path, 1};
+	if (tok.file == nullptr) {
+		fprintf(stderr, "Error: cannot open arm description %s.\n", path);
+		exit(EXIT_FAILURE);
+	}
+	JointSpec joints[MAX_JOINTS];
+	float lower[MAX_JOINTS], upper[MAX_JOINTS];
+	bool has_limits[MAX_JOINTS];
+	LinkInertia links[MAX_JOINTS];
+	bool has_link[MAX_JOINTS];
+	int n_joints = 0;
+	bool has_home = false;
+	float home[12];
+
+	char keyword[64];
+	while (nextToken(tok, keyword, sizeof(keyword))) {
+		if (strcmp(keyword, "joint") == 0) {
+			if (n_joints == MAX_JOINTS) {
+				fprintf(stderr, "Error: %s:%d: more than %d joints.\n", path, tok.line, MAX_JOINTS);
+				exit(EXIT_FAILURE);
+			}
+			JointSpec &j = joints[n_joints];
+			j.omega.x = nextNumber(tok, "the joint axis");
+			j.omega.y = nextNumber(tok, "the joint axis");
+			j.omega.z = nextNumber(tok, "the joint axis");
+			j.point.x = nextNumber(tok, "the point on the joint axis");
+			j.point.y = nextNumber(tok, "the point on the joint axis");
+			j.point.z = nextNumber(tok, "the point on the joint axis");
+			if (linalg::norm(j.omega) < 1e-6f) {
+				fprintf(stderr, "Error: %s:%d: joint axis must not be zero.\n", path, tok.line);
+				exit(EXIT_FAILURE);
+			}
+			j.omega = linalg::normalize(j.omega);
+			has_limits[n_joints] = peekNumberOnLine(tok);
+			if (has_limits[n_joints]) {
+				lower[n_joints] = nextNumber(tok, "the lower joint limit");
+				upper[n_joints] = nextNumber(tok, "the upper joint limit");
+			}
+			has_link[n_joints] = false;
+			n_joints++;
+		} else if (strcmp(keyword, "link") == 0) {
+			if (n_joints == 0 || has_link[n_joints - 1]) {
+				fprintf(stderr, "Error: %s:%d: 'link' must follow its joint, once per joint.\n", path, tok.line);
+				exit(EXIT_FAILURE);
+			}
+			LinkInertia &l = links[n_joints - 1];
+			l.mass = nextNumber(tok, "the link mass");
+			l.com.x = nextNumber(tok, "the link centre of mass");
+			l.com.y = nextNumber(tok, "the link centre of mass");
+			l.com.z = nextNumber(tok, "the link centre of mass");
+			float I[6];
+			for (int k = 0; k < 6; k++) {
+				I[k] = nextNumber(tok, "the link inertia");
+			}
+			l.inertia = linalg::Mat3{{I[0], I[3], I[4],
+						  I[3], I[1], I[5],
+						  I[4], I[5], I[2]}};
+			if (l.mass < 0) {
+				fprintf(stderr, "Error: %s:%d: link mass must not be negative.\n", path, tok.line);
+				exit(EXIT_FAILURE);
+			}
+			has_link[n_joints - 1] = true;
+		} else if (strcmp(keyword, "home") == 0) {
+			for (int k = 0; k < 12; k++) {
+				home[k] = nextNumber(tok, "the home transform");
+			}
+			has_home = true;
+		} else {
+			fprintf(stderr, "Error: %s:%d: unknown keyword '%s'.\n", path, tok.line, keyword);
+			exit(EXIT_FAILURE);
+		}
+	}
+	fclose(tok.file);
+
+	if (n_joints == 0 || !has_home) {
+		fprintf(stderr, "Error: %s: an arm description needs at least one joint and a home transform.\n", path);
+		exit(EXIT_FAILURE);
+	}
+	float M_vals[16] = {home[0], home[1], home[2], home[3],
+			    home[4], home[5], home[6], home[7],
+			    home[8], home[9], home[10], home[11],
+			    0, 0, 0, 1};
+	RobotModel model(joints, n_joints, linalg::fromHomogeneous(M_vals));
+	for (int i = 0; i < n_joints; i++) {
+		if (has_limits[i]) {
+			model.setJointLimits(i, lower[i], upper[i]);
+		}
+		if (has_link[i]) {
+			model.setLinkInertia(i, links[i]);
+		}
+	}
+	return model;
+}
+
+/*===================Binary cache===================*/
+
+static bool sourceStamp(const char *path, int64_t &size, int64_t &mtime_ns) {
+	struct stat st;
+	if (stat(path, &st) != 0) {
+		return false;
+	}
+	size = st.st_size;
+	mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+	return true;
+}
+
+bool kinematics::writeModelCache(const RobotModel &model, const char *cache_path, const char *description_path) {
+	CacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.n_joints = model.n_joints_;
+	if (description_path != nullptr && !sourceStamp(description_path, header.source_size, header.source_mtime_ns)) {
+		return false;
+	}
+	// Write to a temporary file and rename, so readers never load a half-written cache
+	char tmp_path[4096];
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", cache_path, (int)getpid());
+	FILE *f = fopen(tmp_path, "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	size_t n = model.n_joints_;
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		  fwrite(&model.M_, sizeof(model.M_), 1, f) == 1 &&
+		  fwrite(model.screws_, sizeof(Screw), n, f) == n &&
+		  fwrite(model.body_screws_, sizeof(Screw), n, f) == n &&
+		  fwrite(model.specs_, sizeof(JointSpec), n, f) == n &&
+		  fwrite(model.lower_, sizeof(float), n, f) == n &&
+		  fwrite(model.upper_, sizeof(float), n, f) == n &&
+		  fwrite(model.inertia_, sizeof(LinkInertia), n, f) == n;
+	ok = (fclose(f) == 0) && ok;
+	if (!ok || rename(tmp_path, cache_path) != 0) {
+		unlink(tmp_path);
+		return false;
+	}
+	return true;
+}
+
+kinematics::CachedRobotModel::CachedRobotModel() : model_(nullptr) {
+}
+
+kinematics::CachedRobotModel::~CachedRobotModel() {
+	release();
+}
+
+void kinematics::CachedRobotModel::release() {
+	delete model_;
+	model_ = nullptr;
+}
+
+bool kinematics::CachedRobotModel::load(const char *cache_path, const char *description_path) {
+	release();
+	int fd = open(cache_path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	CacheHeader header;
+	struct stat st;
+	bool valid = read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+		     memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+		     header.version == CACHE_VERSION &&
+		     header.n_joints >= 1 && header.n_joints <= (uint32_t)MAX_JOINTS &&
+		     fstat(fd, &st) == 0 && (size_t)st.st_size == cacheSize(header.n_joints);
+	if (valid && description_path != nullptr) {
+		int64_t source_size, source_mtime_ns;
+		valid = sourceStamp(description_path, source_size, source_mtime_ns) &&
+			source_size == header.source_size && source_mtime_ns == header.source_mtime_ns;
+	}
+	if (!valid) {
+		close(fd);
+		return false;
+	}
+
+	// Scatter the sections straight into the model's arrays with a single read
+	RobotModel *model = new RobotModel();
+	size_t n = header.n_joints;
+	struct iovec sections[7] = {
+		{&model->M_, sizeof(model->M_)},
+		{model->screws_, n * sizeof(Screw)},
+		{model->body_screws_, n * sizeof(Screw)},
+		{model->specs_, n * sizeof(JointSpec)},
+		{model->lower_, n * sizeof(float)},
+		{model->upper_, n * sizeof(float)},
+		{model->inertia_, n * sizeof(LinkInertia)},
+	};
+	ssize_t expected = (ssize_t)(cacheSize(n) - sizeof(CacheHeader));
+	valid = readv(fd, sections, 7) == expected;
+	close(fd);
+	if (!valid) {
+		delete model;
+		return false;
+	}
+	model->n_joints_ = (int)n;
+	model_ = model;
+	return true;
+}
+
+void kinematics::CachedRobotModel::adopt(const RobotModel &model) {
+	release();
+	model_ = new RobotModel(model);
+}
+
+void kinematics::loadRobotModel(const char *description_path, const char *cache_path, CachedRobotModel &out) {
+	if (cache_path == nullptr) {
+		out.adopt(parseArmDescription(description_path));
+		return;
+	}
+	if (out.load(cache_path, description_path)) {
+		return;
+	}
+	RobotModel model = parseArmDescription(description_path);
+	writeModelCache(model, cache_path, description_path);
+	out.adopt(model);
+}
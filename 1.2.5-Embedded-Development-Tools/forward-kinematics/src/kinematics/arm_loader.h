@@ -0,0 +1,48 @@
+#ifndef __KINEMATICS_ARM_LOADER__
+#define __KINEMATICS_ARM_LOADER__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// Parses a text arm description (see arms/course_arm.txt):
+	//   joint <ax ay az> <qx qy qz> [<lower> <upper>]   one line per revolute joint
+	//   link <m> <cx cy cz> <Ixx Iyy Izz Ixy Ixz Iyz>   optional inertia of the link moved by the
+	//                                                   joint above it (see LinkInertia), may span lines
+	//   home <12 values>                                top 3x4 rows of M, may span lines
+	// '#' starts a comment. Exits with an error message on malformed input.
+	RobotModel parseArmDescription(const char *path);
+
+	// Writes model as a compact binary cache: a header with the joint count, the description
+	// file's size and modification time (so a stale cache is detected without parsing) and the
+	// home transform, then the first n_joints entries of each per-joint array. Returns false on I/O errors.
+	bool writeModelCache(const RobotModel &model, const char *cache_path, const char *description_path);
+
+	// RobotModel loaded from a binary cache. Loading is a header check and one
+	// scattered read straight into the model's arrays, without parsing or recomputing screws.
+	class CachedRobotModel {
+	public:
+		CachedRobotModel();
+		~CachedRobotModel();
+		CachedRobotModel(const CachedRobotModel &) = delete;
+		CachedRobotModel &operator=(const CachedRobotModel &) = delete;
+
+		// Loads cache_path if it is a valid cache for description_path
+		// (pass nullptr to skip the staleness check). Returns false otherwise.
+		bool load(const char *cache_path, const char *description_path);
+		// Holds a copy of model instead, when no cache could be loaded
+		void adopt(const RobotModel &model);
+		void release();
+
+		const RobotModel *get() const { return model_; }
+
+	private:
+		RobotModel *model_;
+	};
+
+	// Startup path: loads the cache if it is fresh, otherwise parses the description
+	// and rewrites the cache. With cache_path == nullptr it only parses, and writes nothing.
+	void loadRobotModel(const char *description_path, const char *cache_path, CachedRobotModel &out);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_ARM_LOADER__*/
@@ -0,0 +1,83 @@
+#ifndef __KINEMATICS_ARM_SPECS__
+#define __KINEMATICS_ARM_SPECS__
+
+#include "robot_model.h"
+#include "joint_types.h"
+#include "collision.h"
+
+namespace kinematics {
+	// 4-DOF arm used in the course: base yaw about z, then three pitch joints about x
+	typedef struct RoboticArmSpecs {
+		const int N_JOINTS = 4;
+		// In milimeters
+		const float L1 = 31.0f;
+		const float L2 = 80.0f;
+		const float L3 = 80.0f;
+		const float L4 = 62.0f;
+		// In kilograms, servo and bracket included (rough estimates)
+		const float M1 = 0.060f;
+		const float M2 = 0.080f;
+		const float M3 = 0.070f;
+		const float M4 = 0.050f;
+	} RoboticArmSpecs;
+
+	// Joint axes, points on the axes and home transform of the arm as functions of
+	// the link lengths. Templated so the lengths can carry derivatives.
+	template <typename T>
+	inline void buildArmJoints(const T &L1, const T &L2, const T &L3, JointSpecT<T> joints[4], linalg::TransformT<T> &M) {
+		const T zero(0), one(1);
+		joints[0] = JointSpecT<T>{{zero, zero, one}, {zero, zero, zero}};
+		joints[1] = JointSpecT<T>{{one, zero, zero}, {zero, zero, L1}};
+		joints[2] = JointSpecT<T>{{one, zero, zero}, {zero, zero, L1 + L2}};
+		joints[3] = JointSpecT<T>{{one, zero, zero}, {zero, zero, L1 + L2 + L3}};
+		M.R = linalg::Mat3T<T>{{zero, zero, one,
+					one, zero, zero,
+					zero, one, zero}};
+		M.p = linalg::Vec3T<T>{zero, zero, L1 + L2 + L3};
+	}
+
+	// Solid cylinder of the given radius along z from z0 to z1, as a stand-in for a link
+	inline LinkInertia cylinderInertia(float mass, float z0, float z1, float radius) {
+		float length = z1 - z0;
+		float Ixx = mass * (3.0f * radius * radius + length * length) / 12.0f;
+		float Izz = 0.5f * mass * radius * radius;
+		return LinkInertia{mass, {0.0f, 0.0f, 0.5f * (z0 + z1)}, {{Ixx, 0.0f, 0.0f,
+									   0.0f, Ixx, 0.0f,
+									   0.0f, 0.0f, Izz}}};
+	}
+
+	inline RobotModel makeRobotModel(const RoboticArmSpecs &arm) {
+		JointSpec joints[4];
+		linalg::Transform M;
+		buildArmJoints(arm.L1, arm.L2, arm.L3, joints, M);
+		RobotModel model(joints, arm.N_JOINTS, M);
+		// Same envelopes as makeCourseArmCapsules; the last link carries the gripper
+		const float z1 = arm.L1, z2 = arm.L1 + arm.L2, z3 = arm.L1 + arm.L2 + arm.L3;
+		model.setLinkInertia(0, cylinderInertia(arm.M1, 0.0f, z1, 20.0f));
+		model.setLinkInertia(1, cylinderInertia(arm.M2, z1, z2, 12.0f));
+		model.setLinkInertia(2, cylinderInertia(arm.M3, z2, z3, 12.0f));
+		model.setLinkInertia(3, cylinderInertia(arm.M4, z3, z3 + arm.L4, 10.0f));
+		return model;
+	}
+
+	// Capsules around the four links, in the home configuration (arm straight up).
+	// L4 carries the gripper past the last pitch joint, which the PoE home pose
+	// stops at. Radii are rough envelopes of the servo brackets, mm.
+	inline void makeCourseArmCapsules(const RoboticArmSpecs &arm, LinkCapsule capsules[4]) {
+		const float z1 = arm.L1, z2 = arm.L1 + arm.L2, z3 = arm.L1 + arm.L2 + arm.L3;
+		capsules[0] = LinkCapsule{0, Capsule{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, z1}, 20.0f}};
+		capsules[1] = LinkCapsule{1, Capsule{{0.0f, 0.0f, z1}, {0.0f, 0.0f, z2}, 12.0f}};
+		capsules[2] = LinkCapsule{2, Capsule{{0.0f, 0.0f, z2}, {0.0f, 0.0f, z3}, 12.0f}};
+		capsules[3] = LinkCapsule{3, Capsule{{0.0f, 0.0f, z3}, {0.0f, 0.0f, z3 + arm.L4}, 10.0f}};
+	}
+
+	// The same arm with its joint structure known at compile time
+	typedef JointChain<RevoluteZ, RevoluteX, RevoluteX, RevoluteX> CourseArmChain;
+
+	inline CourseArmChain makeCourseArmChain(const RoboticArmSpecs &arm) {
+		return CourseArmChain::fromModel(makeRobotModel(arm));
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_ARM_SPECS__*/
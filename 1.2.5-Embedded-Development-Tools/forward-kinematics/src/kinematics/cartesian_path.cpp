@@ -0,0 +1,96 @@
+#include "cartesian_path.h"
+#include "fk_simd.h"
+#include <cmath>
+
+// Samples per vectorized pass, sized to keep the scratch arrays in L1
+static const int PATH_CHUNK = 128;
+// Rotations below this are treated as pure translations
+static const float MIN_ANGLE = 1e-6f;
+
+kinematics::CartesianPath::CartesianPath(const linalg::Transform &from, const linalg::Transform &to, CartesianInterpolation mode)
+	: from_(from), mode_(mode) {
+	twist_ = logTransform(linalg::compose(linalg::inverse(from), to));
+	angle_ = linalg::norm(twist_.w);
+	dp_ = to.p - from.p;
+	if (angle_ < MIN_ANGLE) {
+		// Move by v per unit "angle" with no rotation, and let the angle run from 0 to 1
+		axis_ = makeScrew(Twist{{0.0f, 0.0f, 0.0f}, twist_.v});
+		angle_ = 0.0f;
+		return;
+	}
+	float inv = 1.0f / angle_;
+	linalg::Vec3 v = mode == INTERP_SCREW ? twist_.v * inv : linalg::Vec3{0.0f, 0.0f, 0.0f};
+	axis_ = makeScrew(Twist{twist_.w * inv, v});
+}
+
+linalg::Transform kinematics::CartesianPath::at(float s) const {
+	linalg::Transform out;
+	sample(&s, 1, &out);
+	return out;
+}
+
+void kinematics::CartesianPath::sample(const float *s, long n, linalg::Transform *out) const {
+	alignas(64) float sn[PATH_CHUNK], a[PATH_CHUNK], b[PATH_CHUNK], t[PATH_CHUNK];
+	const bool pure_translation = angle_ == 0.0f;
+	const Screw &S = axis_;
+	const linalg::Mat3 &R0 = from_.R;
+	for (long k0 = 0; k0 < n; k0 += PATH_CHUNK) {
+		const int m = n - k0 < PATH_CHUNK ? (int)(n - k0) : PATH_CHUNK;
+		// Coefficients of e^([S] theta) per sample, as in expScrew; a pure translation
+		// uses theta = s and only the I theta term of the translation
+		#pragma omp simd
+		for (int k = 0; k < m; k++) {
+			float theta = pure_translation ? s[k0 + k] : angle_ * s[k0 + k];
+			float c;
+			sinCosLanes(theta, sn[k], c);
+			t[k] = theta;
+			a[k] = 1.0f - c;
+			b[k] = theta - sn[k];
+		}
+		#pragma omp simd
+		for (int k = 0; k < m; k++) {
+			// E = e^([S] theta), then out = from * E
+			float R[9], G[9];
+			for (int i = 0; i < 9; i++) {
+				R[i] = S.W.m[i] * sn[k] + S.W2.m[i] * a[k];
+				G[i] = S.W.m[i] * a[k] + S.W2.m[i] * b[k];
+			}
+			for (int i = 0; i < 9; i += 4) {
+				R[i] += 1.0f;
+				G[i] += t[k];
+			}
+			float p[3];
+			for (int r = 0; r < 3; r++) {
+				p[r] = G[r * 3] * S.v.x + G[r * 3 + 1] * S.v.y + G[r * 3 + 2] * S.v.z;
+			}
+			linalg::Transform &T = out[k0 + k];
+			for (int r = 0; r < 3; r++) {
+				for (int c = 0; c < 3; c++) {
+					T.R.m[r * 3 + c] = R0.m[r * 3] * R[c] + R0.m[r * 3 + 1] * R[3 + c] + R0.m[r * 3 + 2] * R[6 + c];
+				}
+			}
+			if (mode_ == INTERP_SCREW) {
+				T.p.x = R0.m[0] * p[0] + R0.m[1] * p[1] + R0.m[2] * p[2] + from_.p.x;
+				T.p.y = R0.m[3] * p[0] + R0.m[4] * p[1] + R0.m[5] * p[2] + from_.p.y;
+				T.p.z = R0.m[6] * p[0] + R0.m[7] * p[1] + R0.m[8] * p[2] + from_.p.z;
+			} else {
+				float u = s[k0 + k];
+				T.p.x = from_.p.x + dp_.x * u;
+				T.p.y = from_.p.y + dp_.y * u;
+				T.p.z = from_.p.z + dp_.z * u;
+			}
+		}
+	}
+}
+
+void kinematics::CartesianPath::sampleUniform(long n, linalg::Transform *out) const {
+	alignas(64) float s[PATH_CHUNK];
+	const float step = n > 1 ? 1.0f / (n - 1) : 0.0f;
+	for (long k0 = 0; k0 < n; k0 += PATH_CHUNK) {
+		const int m = n - k0 < PATH_CHUNK ? (int)(n - k0) : PATH_CHUNK;
+		for (int k = 0; k < m; k++) {
+			s[k] = (k0 + k) * step;
+		}
+		sample(s, m, out + k0);
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef __KINEMATICS_CARTESIAN_PATH__
+#define __KINEMATICS_CARTESIAN_PATH__
+
+#include "screw.h"
+
+namespace kinematics {
+	typedef enum CartesianInterpolation {
+		// Constant twist in the start frame: the tool turns about and slides along one fixed screw axis
+		INTERP_SCREW,
+		// Straight line for the position, rotation about a fixed axis for the orientation
+		INTERP_DECOUPLED
+	} CartesianInterpolation;
+
+	// Poses between two end-effector transforms, parametrized by s in [0, 1].
+	// The relative twist log(from^-1 to) is computed once in the constructor and its
+	// screw matrices are kept, so each sample only costs a sine, a cosine and a compose.
+	class CartesianPath {
+	public:
+		CartesianPath(const linalg::Transform &from, const linalg::Transform &to,
+			      CartesianInterpolation mode = INTERP_SCREW);
+
+		linalg::Transform at(float s) const;
+		// out[k] = at(s[k]), evaluated in vectorized passes over the samples
+		void sample(const float *s, long n, linalg::Transform *out) const;
+		// n evenly spaced poses, both ends included, e.g. one IK target per control tick
+		void sampleUniform(long n, linalg::Transform *out) const;
+
+		// Relative twist from the start pose to the end pose, in the start frame
+		const Twist &twist() const { return twist_; }
+		// Total rotation, rad
+		float angle() const { return angle_; }
+
+	private:
+		linalg::Transform from_;
+		CartesianInterpolation mode_;
+		Twist twist_;
+		// Unit-rotation screw of twist_ (or its rotation alone for INTERP_DECOUPLED);
+		// a pure translation keeps W = W2 = 0 and moves along v per unit angle
+		Screw axis_;
+		float angle_;
+		// End position minus start position, for INTERP_DECOUPLED
+		linalg::Vec3 dp_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_CARTESIAN_PATH__*/
@@ -0,0 +1,219 @@
+#include "collision.h"
+#include "fk_scan.h"
+#include "fk_simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+
+static const float SEGMENT_EPS = 1e-9f;
+
+static inline float clamp01(float x) {
+	return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+// Closest points of two segments (Ericson, Real-Time Collision Detection 5.1.9) written
+// with selects only, so that the lane loops below vectorize
+static inline float segmentDistance2(float p1x, float p1y, float p1z, float q1x, float q1y, float q1z,
+				     float p2x, float p2y, float p2z, float q2x, float q2y, float q2z) {
+	float d1x = q1x - p1x, d1y = q1y - p1y, d1z = q1z - p1z;
+	float d2x = q2x - p2x, d2y = q2y - p2y, d2z = q2z - p2z;
+	float rx = p1x - p2x, ry = p1y - p2y, rz = p1z - p2z;
+	float a = d1x * d1x + d1y * d1y + d1z * d1z;
+	float e = d2x * d2x + d2y * d2y + d2z * d2z;
+	float b = d1x * d2x + d1y * d2y + d1z * d2z;
+	float c = d1x * rx + d1y * ry + d1z * rz;
+	float f = d2x * rx + d2y * ry + d2z * rz;
+	float denom = a * e - b * b;
+	float inv_a = a > SEGMENT_EPS ? 1.0f / a : 0.0f;
+	// Parallel segments start from s = 0; a second segment that is a point (a sphere)
+	// has t = 0 and s from projecting it onto the first
+	float s = denom > SEGMENT_EPS ? clamp01((b * f - c * e) / denom) : 0.0f;
+	s = e > SEGMENT_EPS ? s : clamp01(-c * inv_a);
+	float t = e > SEGMENT_EPS ? (b * s + f) / e : 0.0f;
+	// t outside [0, 1]: clamp it and recompute s for that end of the second segment
+	float s_low = clamp01(-c * inv_a);
+	float s_high = clamp01((b - c) * inv_a);
+	s = t < 0.0f ? s_low : (t > 1.0f ? s_high : s);
+	t = clamp01(t);
+	float dx = rx + d1x * s - d2x * t;
+	float dy = ry + d1y * s - d2y * t;
+	float dz = rz + d1z * s - d2z * t;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+float kinematics::segmentDistance2(const linalg::Vec3 &p1, const linalg::Vec3 &q1, const linalg::Vec3 &p2, const linalg::Vec3 &q2) {
+	return ::segmentDistance2(p1.x, p1.y, p1.z, q1.x, q1.y, q1.z, p2.x, p2.y, p2.z, q2.x, q2.y, q2.z);
+}
+
+kinematics::CollisionModel::CollisionModel(const RobotModel &model, const LinkCapsule *links, int n_links, float margin)
+	: model_(&model), n_links_(n_links), n_obstacles_(0), margin_(margin) {
+	if (n_links < 1 || n_links > MAX_LINK_CAPSULES) {
+		fprintf(stderr, "Error: a collision model needs between 1 and %d link capsules, got %d.\n", MAX_LINK_CAPSULES, n_links);
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < n_links; i++) {
+		if (links[i].frame < 0 || links[i].frame >= model.nJoints() || links[i].shape.radius < 0) {
+			fprintf(stderr, "Error: link capsule %d has frame %d and radius %f for a %d-joint model.\n",
+				i, links[i].frame, links[i].shape.radius, model.nJoints());
+			exit(EXIT_FAILURE);
+		}
+		links_[i] = links[i];
+		link_bound_[i] = 0.5f * linalg::norm(links[i].shape.b - links[i].shape.a) + links[i].shape.radius;
+	}
+}
+
+int kinematics::CollisionModel::addObstacle(const Capsule &obstacle) {
+	if (n_obstacles_ >= MAX_OBSTACLES) {
+		fprintf(stderr, "Error: a collision model holds at most %d obstacles.\n", MAX_OBSTACLES);
+		exit(EXIT_FAILURE);
+	}
+	int i = n_obstacles_++;
+	obstacles_[i] = obstacle;
+	obstacle_center_[i] = (obstacle.a + obstacle.b) * 0.5f;
+	obstacle_bound_[i] = 0.5f * linalg::norm(obstacle.b - obstacle.a) + obstacle.radius;
+	return i;
+}
+
+bool kinematics::CollisionModel::inCollision(const float *thetas, CollisionReport *report) const {
+	linalg::Transform frames[MAX_JOINTS], tool;
+	fkLinkFrames(*model_, thetas, frames, tool);
+	linalg::Vec3 a[MAX_LINK_CAPSULES], b[MAX_LINK_CAPSULES];
+	for (int i = 0; i < n_links_; i++) {
+		a[i] = linalg::transformPoint(frames[links_[i].frame], links_[i].shape.a);
+		b[i] = linalg::transformPoint(frames[links_[i].frame], links_[i].shape.b);
+	}
+	CollisionReport best{false, -1, -1, false, 3.4e38f};
+	// Without a report only collisions matter, so far pairs are dropped by their bounding spheres
+	auto test = [&](int i, const linalg::Vec3 &pa, const linalg::Vec3 &pb, float radius,
+			const linalg::Vec3 &center, float bound, int other, bool self) {
+		float reach = link_bound_[i] + bound + margin_;
+		linalg::Vec3 dc = (a[i] + b[i]) * 0.5f - center;
+		if (report == nullptr && linalg::dot(dc, dc) >= reach * reach) {
+			return;
+		}
+		float distance = sqrtf(kinematics::segmentDistance2(a[i], b[i], pa, pb)) - links_[i].shape.radius - radius;
+		if (distance < best.distance) {
+			best = CollisionReport{distance < margin_, i, other, self, distance};
+		}
+	};
+	for (int i = 0; i < n_links_; i++) {
+		for (int o = 0; o < n_obstacles_; o++) {
+			test(i, obstacles_[o].a, obstacles_[o].b, obstacles_[o].radius, obstacle_center_[o], obstacle_bound_[o], o, false);
+		}
+		for (int j = i + 1; j < n_links_; j++) {
+			if (abs(links_[j].frame - links_[i].frame) >= 2) {
+				test(i, a[j], b[j], links_[j].shape.radius, (a[j] + b[j]) * 0.5f, link_bound_[j], j, true);
+			}
+		}
+	}
+	if (report != nullptr) {
+		*report = best;
+	}
+	return best.collision;
+}
+
+uint32_t kinematics::CollisionModel::checkLanes(const float *thetas) const {
+	const int L = FK_LANES;
+	TransformBatch frames[MAX_JOINTS], tool;
+	fkLanesFrames(*model_, thetas, frames, tool);
+
+	// World endpoints and midpoints of every link capsule, SoA per lane
+	float A[MAX_LINK_CAPSULES][3][FK_LANES], B[MAX_LINK_CAPSULES][3][FK_LANES], C[MAX_LINK_CAPSULES][3][FK_LANES];
+	for (int i = 0; i < n_links_; i++) {
+		const TransformBatch &F = frames[links_[i].frame];
+		const linalg::Vec3 &a = links_[i].shape.a, &b = links_[i].shape.b;
+		for (int r = 0; r < 3; r++) {
+			#pragma omp simd
+			for (int l = 0; l < L; l++) {
+				A[i][r][l] = F.R[r * 3][l] * a.x + F.R[r * 3 + 1][l] * a.y + F.R[r * 3 + 2][l] * a.z + F.p[r][l];
+				B[i][r][l] = F.R[r * 3][l] * b.x + F.R[r * 3 + 1][l] * b.y + F.R[r * 3 + 2][l] * b.z + F.p[r][l];
+				C[i][r][l] = 0.5f * (A[i][r][l] + B[i][r][l]);
+			}
+		}
+	}
+
+	int hit[FK_LANES] = {0};
+	for (int i = 0; i < n_links_; i++) {
+		const float ri = links_[i].shape.radius;
+		for (int o = 0; o < n_obstacles_; o++) {
+			const Capsule &obs = obstacles_[o];
+			const linalg::Vec3 &oc = obstacle_center_[o];
+			// Broadphase: skip the pair unless some lane's bounding spheres overlap
+			const float reach = link_bound_[i] + obstacle_bound_[o] + margin_;
+			int near = 0;
+			#pragma omp simd reduction(| : near)
+			for (int l = 0; l < L; l++) {
+				float dx = C[i][0][l] - oc.x, dy = C[i][1][l] - oc.y, dz = C[i][2][l] - oc.z;
+				near |= dx * dx + dy * dy + dz * dz < reach * reach;
+			}
+			if (!near) {
+				continue;
+			}
+			const float limit = ri + obs.radius + margin_;
+			#pragma omp simd
+			for (int l = 0; l < L; l++) {
+				float d2 = ::segmentDistance2(A[i][0][l], A[i][1][l], A[i][2][l], B[i][0][l], B[i][1][l], B[i][2][l],
+							      obs.a.x, obs.a.y, obs.a.z, obs.b.x, obs.b.y, obs.b.z);
+				hit[l] |= d2 < limit * limit;
+			}
+		}
+		for (int j = i + 1; j < n_links_; j++) {
+			if (abs(links_[j].frame - links_[i].frame) < 2) {
+				continue;
+			}
+			const float reach = link_bound_[i] + link_bound_[j] + margin_;
+			int near = 0;
+			#pragma omp simd reduction(| : near)
+			for (int l = 0; l < L; l++) {
+				float dx = C[i][0][l] - C[j][0][l], dy = C[i][1][l] - C[j][1][l], dz = C[i][2][l] - C[j][2][l];
+				near |= dx * dx + dy * dy + dz * dz < reach * reach;
+			}
+			if (!near) {
+				continue;
+			}
+			const float limit = ri + links_[j].shape.radius + margin_;
+			#pragma omp simd
+			for (int l = 0; l < L; l++) {
+				float d2 = ::segmentDistance2(A[i][0][l], A[i][1][l], A[i][2][l], B[i][0][l], B[i][1][l], B[i][2][l],
+							      A[j][0][l], A[j][1][l], A[j][2][l], B[j][0][l], B[j][1][l], B[j][2][l]);
+				hit[l] |= d2 < limit * limit;
+			}
+		}
+	}
+	uint32_t mask = 0;
+	for (int l = 0; l < L; l++) {
+		mask |= (uint32_t)(hit[l] != 0) << l;
+	}
+	return mask;
+}
+
+long kinematics::CollisionModel::checkTrajectory(const float *thetas, long n, uint8_t *in_collision) const {
+	const int n_joints = model_->nJoints();
+	const long n_blocks = (n + FK_LANES - 1) / FK_LANES;
+	long colliding = 0;
+	#pragma omp parallel reduction(+ : colliding)
+	{
+		alignas(32) float soa[MAX_JOINTS * FK_LANES];
+		#pragma omp for schedule(static)
+		for (long block = 0; block < n_blocks; block++) {
+			long first = block * FK_LANES;
+			int lanes = n - first < FK_LANES ? (int)(n - first) : FK_LANES;
+			// Transpose to SoA; lanes past the end repeat the last configuration
+			for (int l = 0; l < FK_LANES; l++) {
+				const float *q = thetas + (first + (l < lanes ? l : lanes - 1)) * n_joints;
+				for (int j = 0; j < n_joints; j++) {
+					soa[j * FK_LANES + l] = q[j];
+				}
+			}
+			uint32_t mask = checkLanes(soa);
+			for (int l = 0; l < lanes; l++) {
+				bool hit = (mask >> l) & 1;
+				colliding += hit;
+				if (in_collision != nullptr) {
+					in_collision[first + l] = hit;
+				}
+			}
+		}
+	}
+	return colliding;
+}
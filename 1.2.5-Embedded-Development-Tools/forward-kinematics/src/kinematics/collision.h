@@ -0,0 +1,85 @@
+#ifndef __KINEMATICS_COLLISION__
+#define __KINEMATICS_COLLISION__
+
+#include <stdint.h>
+#include "robot_model.h"
+
+namespace kinematics {
+	// Fixed so that a CollisionModel is trivially copyable and checks never allocate
+	const int MAX_LINK_CAPSULES = 16;
+	const int MAX_OBSTACLES = 64;
+
+	// Segment [a, b] swept by a sphere; a == b is a sphere
+	typedef struct Capsule {
+		linalg::Vec3 a;
+		linalg::Vec3 b;
+		float radius;
+	} Capsule;
+
+	// Capsule carried by a link, given in the home configuration. In the PoE form a
+	// point attached after joint i moves with the link frame e^([S1] theta1) * ... * e^([S(i+1)] theta(i+1)),
+	// so the world capsule is that frame applied to the home endpoints.
+	typedef struct LinkCapsule {
+		int frame;
+		Capsule shape;
+	} LinkCapsule;
+
+	typedef struct CollisionReport {
+		bool collision;
+		// Closest pair: link capsule and either another link (self) or an obstacle
+		int link;
+		int other;
+		bool self;
+		// Surface distance of the closest pair, negative when penetrating
+		float distance;
+	} CollisionReport;
+
+	// Link capsules of one arm plus static obstacles. Links are tested against every
+	// obstacle and against the links more than one frame away from them (neighbours
+	// always touch at their joint). Each pair goes through a bounding-sphere broadphase
+	// before the segment-segment distance test.
+	class CollisionModel {
+	public:
+		// margin is extra clearance required on top of the capsule radii, mm.
+		// The robot model must outlive the collision model.
+		CollisionModel(const RobotModel &model, const LinkCapsule *links, int n_links, float margin = 0.0f);
+
+		// Returns the obstacle index; exits past MAX_OBSTACLES
+		int addObstacle(const Capsule &obstacle);
+		void clearObstacles() { n_obstacles_ = 0; }
+
+		// Scalar check of one configuration from the FK link frames; the report
+		// (optional) describes the closest pair
+		bool inCollision(const float *thetas, CollisionReport *report = nullptr) const;
+
+		// FK_LANES configurations at once, SoA as for fkLanes(); bit l of the result is set if lane l collides
+		uint32_t checkLanes(const float *thetas) const;
+
+		// n configurations, row-major n x nJoints(), split across OpenMP threads and
+		// checked FK_LANES at a time. in_collision (optional) receives a flag per
+		// configuration. Returns the number of colliding configurations.
+		long checkTrajectory(const float *thetas, long n, uint8_t *in_collision = nullptr) const;
+
+		const RobotModel &model() const { return *model_; }
+		int nLinks() const { return n_links_; }
+		int nObstacles() const { return n_obstacles_; }
+
+	private:
+		const RobotModel *model_;
+		LinkCapsule links_[MAX_LINK_CAPSULES];
+		// Bounding sphere radius of each link capsule around its segment midpoint
+		float link_bound_[MAX_LINK_CAPSULES];
+		Capsule obstacles_[MAX_OBSTACLES];
+		linalg::Vec3 obstacle_center_[MAX_OBSTACLES];
+		float obstacle_bound_[MAX_OBSTACLES];
+		int n_links_;
+		int n_obstacles_;
+		float margin_;
+	};
+
+	// Squared distance between segments [p1, q1] and [p2, q2]
+	float segmentDistance2(const linalg::Vec3 &p1, const linalg::Vec3 &q1, const linalg::Vec3 &p2, const linalg::Vec3 &q2);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_COLLISION__*/
@@ -0,0 +1,89 @@
+#ifndef __KINEMATICS_DERIVATIVES__
+#define __KINEMATICS_DERIVATIVES__
+
+#include "linalg/dual.h"
+#include "arm_specs.h"
+#include "fk.h"
+
+namespace kinematics {
+	// Quantity a pose derivative is taken with respect to
+	typedef struct FkParameter {
+		enum Kind { THETA, POINT_X, POINT_Y, POINT_Z, HOME_X, HOME_Y, HOME_Z };
+		Kind kind;
+		int joint; // ignored for HOME_*
+	} FkParameter;
+
+	// Pose value and its N partial derivatives out of a dual-valued transform
+	template <int N>
+	inline void splitDual(const linalg::TransformT<linalg::Dual<N> > &X, linalg::Transform &T, linalg::Transform *dT) {
+		for (int k = 0; k < 9; k++) {
+			T.R.m[k] = X.R.m[k].v;
+			for (int j = 0; j < N; j++) {
+				dT[j].R.m[k] = X.R.m[k].d[j];
+			}
+		}
+		T.p = linalg::Vec3{X.p.x.v, X.p.y.v, X.p.z.v};
+		for (int j = 0; j < N; j++) {
+			dT[j].p = linalg::Vec3{X.p.x.d[j], X.p.y.d[j], X.p.z.d[j]};
+		}
+	}
+
+	// Forward-mode AD through the PoE chain: one pass gives the pose T and
+	// dT[k] = dT / d params[k], entrywise on R and p.
+	template <int N>
+	void fkDerivatives(const RobotModel &model, const float *thetas, const FkParameter *params,
+			   linalg::Transform &T, linalg::Transform *dT) {
+		typedef linalg::Dual<N> D;
+		const int n = model.nJoints();
+		JointSpecT<D> joints[MAX_JOINTS];
+		D dual_thetas[MAX_JOINTS];
+		for (int i = 0; i < n; i++) {
+			const JointSpec &spec = model.jointSpec(i);
+			joints[i].omega = linalg::Vec3T<D>{D(spec.omega.x), D(spec.omega.y), D(spec.omega.z)};
+			joints[i].point = linalg::Vec3T<D>{D(spec.point.x), D(spec.point.y), D(spec.point.z)};
+			dual_thetas[i] = D(thetas[i]);
+		}
+		const linalg::Transform &M = model.home();
+		linalg::TransformT<D> dual_M;
+		for (int k = 0; k < 9; k++) {
+			dual_M.R.m[k] = D(M.R.m[k]);
+		}
+		dual_M.p = linalg::Vec3T<D>{D(M.p.x), D(M.p.y), D(M.p.z)};
+
+		// Seed one unit tangent per requested parameter
+		for (int k = 0; k < N; k++) {
+			const FkParameter &param = params[k];
+			switch (param.kind) {
+			case FkParameter::THETA:   dual_thetas[param.joint].d[k] = 1; break;
+			case FkParameter::POINT_X: joints[param.joint].point.x.d[k] = 1; break;
+			case FkParameter::POINT_Y: joints[param.joint].point.y.d[k] = 1; break;
+			case FkParameter::POINT_Z: joints[param.joint].point.z.d[k] = 1; break;
+			case FkParameter::HOME_X:  dual_M.p.x.d[k] = 1; break;
+			case FkParameter::HOME_Y:  dual_M.p.y.d[k] = 1; break;
+			case FkParameter::HOME_Z:  dual_M.p.z.d[k] = 1; break;
+			}
+		}
+
+		linalg::TransformT<D> X;
+		forwardKinematicsT(joints, n, dual_M, dual_thetas, X);
+		splitDual(X, T, dT);
+	}
+
+	// Course arm: dT[0..3] = dT/dtheta1..4, dT[4..6] = dT/dL1..L3.
+	// L4 does not enter the model (the home pose ends at joint 4), so dT/dL4 = 0.
+	inline void fkArmDerivatives(const RoboticArmSpecs &arm, const float *thetas, linalg::Transform &T, linalg::Transform *dT) {
+		typedef linalg::Dual<7> D;
+		JointSpecT<D> joints[4];
+		linalg::TransformT<D> M, X;
+		buildArmJoints(D::variable(arm.L1, 4), D::variable(arm.L2, 5), D::variable(arm.L3, 6), joints, M);
+		D dual_thetas[4];
+		for (int i = 0; i < 4; i++) {
+			dual_thetas[i] = D::variable(thetas[i], i);
+		}
+		forwardKinematicsT(joints, 4, M, dual_thetas, X);
+		splitDual(X, T, dT);
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_DERIVATIVES__*/
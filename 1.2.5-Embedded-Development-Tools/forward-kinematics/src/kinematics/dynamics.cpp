@@ -0,0 +1,77 @@
+#include "dynamics.h"
+
+kinematics::InverseDynamics::InverseDynamics(const RobotModel &model, const linalg::Vec3 &gravity)
+	: model_(&model), n_joints_(model.nJoints()) {
+	gravity_accel_ = Vec6{{0.0f, 0.0f, 0.0f, -gravity.x, -gravity.y, -gravity.z}};
+	linalg::Vec3 prev_com{0.0f, 0.0f, 0.0f};
+	for (int i = 0; i < n_joints_; i++) {
+		const LinkInertia &link = model.linkInertia(i);
+		// M_i = (I, com_i), so A_i = [Ad_{M_i^-1}] S_i and M_{i,i-1} = (I, com_{i-1} - com_i)
+		linalg::Transform M_inv{linalg::mat3Identity<float>(), -link.com};
+		Twist A = adjoint(M_inv, Twist{model.screw(i).w, model.screw(i).v});
+		A_[i] = makeScrew(A);
+		A6_[i] = toVec6(A);
+		M_rel_[i] = linalg::Transform{linalg::mat3Identity<float>(), prev_com - link.com};
+		G_[i] = spatialInertia(link.inertia, link.mass);
+		prev_com = link.com;
+	}
+}
+
+void kinematics::InverseDynamics::rnea(const float *q, const float *qd, const float *qdd, const Vec6 &base_accel, float *tau) const {
+	const int n = n_joints_;
+	Mat6 Ad[MAX_JOINTS];
+	Vec6 V[MAX_JOINTS], Vd[MAX_JOINTS];
+	Vec6 V_prev = {{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}};
+	Vec6 Vd_prev = base_accel;
+	// Outward: T_{i,i-1} = e^(-[A_i] q_i) M_{i,i-1},
+	//   V_i = [Ad_T] V_{i-1} + A_i qd_i
+	//   Vd_i = [Ad_T] Vd_{i-1} + [ad_{V_i}] A_i qd_i + A_i qdd_i
+	for (int i = 0; i < n; i++) {
+		linalg::Transform E;
+		expScrew(A_[i], -q[i], E);
+		Ad[i] = adjointMatrix(linalg::compose(E, M_rel_[i]));
+		V[i] = mat6MulVec(Ad[i], V_prev) + A6_[i] * qd[i];
+		Vd[i] = mat6MulVec(Ad[i], Vd_prev) + adTwist(V[i], A6_[i]) * qd[i] + A6_[i] * qdd[i];
+		V_prev = V[i];
+		Vd_prev = Vd[i];
+	}
+	// Inward: F_i = [Ad_{T_{i+1,i}}]^T F_{i+1} + G_i Vd_i - [ad_{V_i}]^T G_i V_i,  tau_i = F_i . A_i
+	Vec6 F = {{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}};
+	for (int i = n - 1; i >= 0; i--) {
+		Vec6 F_child = i + 1 < n ? mat6TransposeMulVec(Ad[i + 1], F) : F;
+		F = F_child + mat6MulVec(G_[i], Vd[i]) + adTransposeWrench(V[i], mat6MulVec(G_[i], V[i])) * -1.0f;
+		tau[i] = dot(F, A6_[i]) * MODEL_TORQUE_TO_NM;
+	}
+}
+
+void kinematics::InverseDynamics::torques(const float *q, const float *qd, const float *qdd, float *tau) const {
+	rnea(q, qd, qdd, gravity_accel_, tau);
+}
+
+void kinematics::InverseDynamics::gravityTorques(const float *q, float *tau) const {
+	float zero[MAX_JOINTS] = {0};
+	rnea(q, zero, zero, gravity_accel_, tau);
+}
+
+void kinematics::InverseDynamics::massMatrix(const float *q, float *M) const {
+	const int n = n_joints_;
+	const Vec6 no_gravity = {{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}};
+	float zero[MAX_JOINTS] = {0}, unit[MAX_JOINTS] = {0}, column[MAX_JOINTS];
+	// Column j is the torque for a unit acceleration of joint j from rest without gravity
+	for (int j = 0; j < n; j++) {
+		unit[j] = 1.0f;
+		rnea(q, zero, unit, no_gravity, column);
+		unit[j] = 0.0f;
+		for (int i = 0; i < n; i++) {
+			M[i * n + j] = column[i];
+		}
+	}
+}
+
+void kinematics::InverseDynamics::torquesBatch(const float *q, const float *qd, const float *qdd, long n, float *tau) const {
+	const int n_j = n_joints_;
+	#pragma omp parallel for schedule(static)
+	for (long k = 0; k < n; k++) {
+		rnea(q + k * n_j, qd + k * n_j, qdd + k * n_j, gravity_accel_, tau + k * n_j);
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef __KINEMATICS_DYNAMICS__
+#define __KINEMATICS_DYNAMICS__
+
+#include "robot_model.h"
+#include "spatial.h"
+
+namespace kinematics {
+	// The model works in mm, kg and s, so torques come out in kg mm^2 / s^2 = 1e-6 N m
+	const float MODEL_TORQUE_TO_NM = 1e-6f;
+	// Standard gravity along -z, mm/s^2
+	const linalg::Vec3 STANDARD_GRAVITY = {0.0f, 0.0f, -9806.65f};
+
+	// Recursive Newton-Euler inverse dynamics on the PoE model (Lynch & Park, ch. 8.4).
+	// Link i gets a frame at its centre of mass, aligned with the space frame at home;
+	// the joint screws, the home transforms between consecutive link frames and the
+	// spatial inertias are computed once in the constructor from RobotModel::linkInertia.
+	// A solve is one outward pass for link twists and accelerations and one inward pass
+	// for wrenches, O(n), on fixed-size 6-vector and 6x6 kernels with no allocation.
+	// Const after construction, so threads can share it; the model must outlive it.
+	class InverseDynamics {
+	public:
+		explicit InverseDynamics(const RobotModel &model, const linalg::Vec3 &gravity = STANDARD_GRAVITY);
+
+		// tau = M(q) qdd + c(q, qd) + g(q), N m
+		void torques(const float *q, const float *qd, const float *qdd, float *tau) const;
+		// Holding torques g(q), N m
+		void gravityTorques(const float *q, float *tau) const;
+		// Joint-space mass matrix M(q), nJoints x nJoints row-major, kg m^2
+		void massMatrix(const float *q, float *M) const;
+		// n samples, each of the four arrays row-major n x nJoints (e.g. from
+		// Trajectory::sampleUniform), split over OpenMP threads
+		void torquesBatch(const float *q, const float *qd, const float *qdd, long n, float *tau) const;
+
+		int nJoints() const { return n_joints_; }
+
+	private:
+		// RNEA in model units with the base accelerating at base_accel (gravity folded in)
+		void rnea(const float *q, const float *qd, const float *qdd, const Vec6 &base_accel, float *tau) const;
+
+		const RobotModel *model_;
+		int n_joints_;
+		// Base acceleration (0, -g) that stands in for gravity
+		Vec6 gravity_accel_;
+		// Joint screw A_i in link frame i, also as a 6-vector
+		Screw A_[MAX_JOINTS];
+		Vec6 A6_[MAX_JOINTS];
+		// Home pose of link frame i - 1 seen from link frame i
+		linalg::Transform M_rel_[MAX_JOINTS];
+		Mat6 G_[MAX_JOINTS];
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_DYNAMICS__*/
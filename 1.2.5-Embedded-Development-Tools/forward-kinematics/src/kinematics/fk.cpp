@@ -0,0 +1,29 @@
+#include "fk.h"
+
+void kinematics::forwardKinematics(const RobotModel &model, const float *thetas, linalg::Transform &out,
+				   FkDebugHook hook, void *user) {
+	// The first exponential initializes the running product instead of multiplying by I
+	linalg::Transform T, E;
+	expScrew(model.screw(0), thetas[0], T);
+	if (hook) {
+		hook(0, T, T, user);
+	}
+	for (int i = 1; i < model.nJoints(); i++) {
+		expScrew(model.screw(i), thetas[i], E);
+		T = linalg::compose(T, E);
+		if (hook) {
+			hook(i, E, T, user);
+		}
+	}
+	out = linalg::compose(T, model.home());
+}
+
+void kinematics::forwardKinematicsBody(const RobotModel &model, const float *thetas, linalg::Transform &out) {
+	linalg::Transform T = model.home();
+	linalg::Transform E;
+	for (int i = 0; i < model.nJoints(); i++) {
+		expScrew(model.bodyScrew(i), thetas[i], E);
+		T = linalg::compose(T, E);
+	}
+	out = T;
+}
@@ -0,0 +1,36 @@
+#ifndef __KINEMATICS_FK__
+#define __KINEMATICS_FK__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// Debug hook called once per joint with e^([Si] thetai) and the running
+	// product e^([S1] theta1) * ... * e^([Si] thetai)
+	typedef void (*FkDebugHook)(int joint, const linalg::Transform &exp, const linalg::Transform &prefix, void *user);
+
+	// Production forward kinematics: no heap allocation, no I/O, no locks and no
+	// shared mutable state, so it may be called concurrently on the same model.
+	// The hook (if any) runs on the calling thread.
+	void forwardKinematics(const RobotModel &model, const float *thetas, linalg::Transform &out,
+			       FkDebugHook hook = nullptr, void *user = nullptr);
+
+	// Body form of the same pose: out = M * e^([B1] theta1) * ... * e^([Bn] thetan)
+	void forwardKinematicsBody(const RobotModel &model, const float *thetas, linalg::Transform &out);
+
+	// Scalar-generic PoE straight from joint specs, for scalars such as linalg::Dual
+	// that RobotModel does not store. Same result as forwardKinematics for T = float.
+	template <typename T>
+	inline void forwardKinematicsT(const JointSpecT<T> *joints, int n_joints, const linalg::TransformT<T> &M,
+				       const T *thetas, linalg::TransformT<T> &out) {
+		linalg::TransformT<T> P, E;
+		expScrew(makeScrew(joints[0]), thetas[0], P);
+		for (int i = 1; i < n_joints; i++) {
+			expScrew(makeScrew(joints[i]), thetas[i], E);
+			P = linalg::compose(P, E);
+		}
+		out = linalg::compose(P, M);
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK__*/
@@ -0,0 +1,38 @@
+#include "fk_batch.h"
+#include "fk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void kinematics::fkBatch(const RobotModel &model, const float *thetas, linalg::Transform *out, long n) {
+	const int n_joints = model.nJoints();
+	#pragma omp parallel
+	{
+		// Per-thread copy of the model, allocated on this thread's stack (and NUMA node)
+		RobotModel local = model;
+		#pragma omp for schedule(static)
+		for (long i = 0; i < n; i++) {
+			forwardKinematics(local, thetas + i * n_joints, out[i]);
+		}
+	}
+}
+
+void *kinematics::allocBatchBuffer(long n, size_t item_size) {
+	size_t bytes = (size_t)n * item_size;
+	// aligned_alloc needs a size that is a multiple of the alignment
+	size_t padded = (bytes + 63) & ~(size_t)63;
+	char *buf = (char *)aligned_alloc(64, padded > 0 ? padded : 64);
+	if (buf == nullptr) {
+		fprintf(stderr, "Error: failed to allocate a batch buffer of %zu bytes.\n", bytes);
+		exit(EXIT_FAILURE);
+	}
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < n; i++) {
+		memset(buf + i * item_size, 0, item_size);
+	}
+	return buf;
+}
+
+void kinematics::freeBatchBuffer(void *buf) {
+	free(buf);
+}
@@ -0,0 +1,20 @@
+#ifndef __KINEMATICS_FK_BATCH__
+#define __KINEMATICS_FK_BATCH__
+
+#include <stddef.h>
+#include "robot_model.h"
+
+namespace kinematics {
+	// FK over n configurations with OpenMP. thetas is row-major n x nJoints(),
+	// out receives n contiguous poses. Work is split with a static schedule so
+	// that buffers from allocBatchBuffer() are written by the thread that first touched them.
+	void fkBatch(const RobotModel &model, const float *thetas, linalg::Transform *out, long n);
+
+	// 64-byte aligned buffer of n items, first-touched in parallel with the same
+	// static schedule as fkBatch so its pages land on the NUMA node that uses them.
+	void *allocBatchBuffer(long n, size_t item_size);
+	void freeBatchBuffer(void *buf);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK_BATCH__*/
@@ -0,0 +1,238 @@
+#include "fk_cache.h"
+#include "fk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+static_assert(sizeof(linalg::Transform) + kinematics::MAX_CACHE_JOINTS * sizeof(int16_t) + 4 == 64,
+	      "an FkCache entry should fill exactly one cache line");
+
+static long nextPowerOfTwo(long x) {
+	long p = 1;
+	while (p < x) {
+		p <<= 1;
+	}
+	return p;
+}
+
+// splitmix64 finalizer
+static inline uint64_t mix64(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ull;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebull;
+	x ^= x >> 31;
+	return x;
+}
+
+kinematics::FkCache::FkCache(const RobotModel &model, long capacity, float step, int n_shards)
+	: model_(&model), n_joints_(model.nJoints()), step_(step), inv_step_(1.0f / step) {
+	if (n_joints_ > MAX_CACHE_JOINTS) {
+		fprintf(stderr, "Error: the FK cache holds chains of at most %d joints, got %d.\n", MAX_CACHE_JOINTS, n_joints_);
+		exit(EXIT_FAILURE);
+	}
+	if (!(step > 0) || capacity < 1 || n_shards < 1) {
+		fprintf(stderr, "Error: invalid FK cache with capacity %ld, step %f and %d shards.\n", capacity, step, n_shards);
+		exit(EXIT_FAILURE);
+	}
+	for (int j = 0; j < n_joints_; j++) {
+		float reach = fmaxf(fabsf(model.jointLower(j)), fabsf(model.jointUpper(j)));
+		if (reach * inv_step_ > INT16_MAX) {
+			fprintf(stderr, "Error: step %f is too fine for the limits of joint %d.\n", step, j);
+			exit(EXIT_FAILURE);
+		}
+	}
+	n_shards_ = (int)nextPowerOfTwo(n_shards);
+	slots_per_shard_ = nextPowerOfTwo((capacity + n_shards_ - 1) / n_shards_);
+	if (slots_per_shard_ < CACHE_WAYS) {
+		slots_per_shard_ = CACHE_WAYS;
+	}
+	shards_.reset(new Shard[n_shards_]);
+	entries_.reset(new Entry[(long)n_shards_ * slots_per_shard_]);
+	for (long i = 0; i < (long)n_shards_ * slots_per_shard_; i++) {
+		entries_[i].seq.store(0, std::memory_order_relaxed);
+	}
+	clear();
+}
+
+uint64_t kinematics::FkCache::quantize(const float *thetas, int16_t *key) const {
+	int16_t padded[8] = {0};
+	for (int j = 0; j < n_joints_; j++) {
+		long q = lrintf(thetas[j] * inv_step_);
+		key[j] = padded[j] = (int16_t)(q < INT16_MIN ? INT16_MIN : (q > INT16_MAX ? INT16_MAX : q));
+	}
+	uint64_t a, b;
+	memcpy(&a, padded, 8);
+	memcpy(&b, padded + 4, 8);
+	return mix64(a ^ mix64(b + 0x9e3779b97f4a7c15ull));
+}
+
+bool kinematics::FkCache::read(const Entry *shard_entries, uint64_t hash, const int16_t *key, linalg::Transform &out) const {
+	const long mask = slots_per_shard_ - 1;
+	for (int w = 0; w < CACHE_WAYS; w++) {
+		const Entry &e = shard_entries[(hash + w) & mask];
+		bool match;
+		uint16_t seq;
+		do {
+			// Wait out a writer, then check that none started while the fields were copied
+			while ((seq = e.seq.load(std::memory_order_acquire)) & 1) {
+			}
+			match = e.used && memcmp(e.key, key, n_joints_ * sizeof(int16_t)) == 0;
+			if (match) {
+				out = e.T;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while (e.seq.load(std::memory_order_relaxed) != seq);
+		if (match) {
+			// Skip the store when already set, so hits leave the line shared
+			if (!e.referenced.load(std::memory_order_relaxed)) {
+				const_cast<Entry &>(e).referenced.store(1, std::memory_order_relaxed);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+kinematics::FkCache::Entry *kinematics::FkCache::find(Entry *shard_entries, uint64_t hash, const int16_t *key) const {
+	const long mask = slots_per_shard_ - 1;
+	for (int w = 0; w < CACHE_WAYS; w++) {
+		Entry &e = shard_entries[(hash + w) & mask];
+		if (e.used && memcmp(e.key, key, n_joints_ * sizeof(int16_t)) == 0) {
+			return &e;
+		}
+	}
+	return nullptr;
+}
+
+void kinematics::FkCache::store(Entry &e, const int16_t *key, uint8_t used, const linalg::Transform *T) {
+	uint16_t seq = e.seq.load(std::memory_order_relaxed);
+	e.seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	if (key != nullptr) {
+		memcpy(e.key, key, n_joints_ * sizeof(int16_t));
+	}
+	e.used = used;
+	if (T != nullptr) {
+		e.T = *T;
+	}
+	e.referenced.store(0, std::memory_order_relaxed);
+	e.seq.store(seq + 2, std::memory_order_release);
+}
+
+void kinematics::FkCache::insert(Shard &shard, Entry *shard_entries, uint64_t hash, const int16_t *key, const linalg::Transform &T) {
+	const long mask = slots_per_shard_ - 1;
+	Entry *victim = nullptr;
+	for (int w = 0; w < CACHE_WAYS && victim == nullptr; w++) {
+		Entry &e = shard_entries[(hash + w) & mask];
+		if (!e.used) {
+			victim = &e;
+		}
+	}
+	if (victim == nullptr) {
+		// Second chance: skip and clear referenced slots; if every slot was referenced,
+		// the first one (now cleared) goes
+		for (int w = 0; w < CACHE_WAYS && victim == nullptr; w++) {
+			Entry &e = shard_entries[(hash + w) & mask];
+			if (e.referenced.load(std::memory_order_relaxed)) {
+				e.referenced.store(0, std::memory_order_relaxed);
+			} else {
+				victim = &e;
+			}
+		}
+		if (victim == nullptr) {
+			victim = &shard_entries[hash & mask];
+		}
+		shard.evictions++;
+	} else {
+		shard.entries++;
+	}
+	store(*victim, key, 1, &T);
+	shard.inserts++;
+}
+
+void kinematics::FkCache::fk(const float *thetas, linalg::Transform &out) {
+	int16_t key[MAX_CACHE_JOINTS];
+	uint64_t hash = quantize(thetas, key);
+	// Shard from the high bits, slot from the low bits
+	const int s = (int)(hash >> 40) & (n_shards_ - 1);
+	Shard &shard = shards_[s];
+	Entry *shard_entries = &entries_[s * slots_per_shard_];
+	if (read(shard_entries, hash, key, out)) {
+		shard.hits.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	shard.misses.fetch_add(1, std::memory_order_relaxed);
+	// FK without the lock; the result is that of the snapped angles, so every hit matches it
+	float snapped[MAX_CACHE_JOINTS];
+	for (int j = 0; j < n_joints_; j++) {
+		snapped[j] = key[j] * step_;
+	}
+	forwardKinematics(*model_, snapped, out);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	// Another thread may have stored the same configuration meanwhile
+	if (find(shard_entries, hash, key) == nullptr) {
+		insert(shard, shard_entries, hash, key, out);
+	}
+}
+
+bool kinematics::FkCache::lookup(const float *thetas, linalg::Transform &out) {
+	int16_t key[MAX_CACHE_JOINTS];
+	uint64_t hash = quantize(thetas, key);
+	const int s = (int)(hash >> 40) & (n_shards_ - 1);
+	Shard &shard = shards_[s];
+	if (!read(&entries_[s * slots_per_shard_], hash, key, out)) {
+		shard.misses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	shard.hits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+kinematics::FkCacheStats kinematics::FkCache::stats() const {
+	FkCacheStats total = {0, 0, 0, 0, 0};
+	for (int s = 0; s < n_shards_; s++) {
+		Shard &shard = shards_[s];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		total.hits += shard.hits.load(std::memory_order_relaxed);
+		total.misses += shard.misses.load(std::memory_order_relaxed);
+		total.inserts += shard.inserts;
+		total.evictions += shard.evictions;
+		total.entries += shard.entries;
+	}
+	return total;
+}
+
+float kinematics::FkCache::hitRate() const {
+	FkCacheStats st = stats();
+	long lookups = st.hits + st.misses;
+	return lookups > 0 ? (float)st.hits / lookups : 0.0f;
+}
+
+void kinematics::FkCache::resetStats() {
+	for (int s = 0; s < n_shards_; s++) {
+		Shard &shard = shards_[s];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.hits.store(0, std::memory_order_relaxed);
+		shard.misses.store(0, std::memory_order_relaxed);
+		shard.inserts = 0;
+		shard.evictions = 0;
+	}
+}
+
+void kinematics::FkCache::clear() {
+	for (int s = 0; s < n_shards_; s++) {
+		Shard &shard = shards_[s];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		shard.hits.store(0, std::memory_order_relaxed);
+		shard.misses.store(0, std::memory_order_relaxed);
+		shard.inserts = 0;
+		shard.evictions = 0;
+		shard.entries = 0;
+		Entry *shard_entries = &entries_[s * slots_per_shard_];
+		for (long i = 0; i < slots_per_shard_; i++) {
+			store(shard_entries[i], nullptr, 0, nullptr);
+		}
+	}
+}
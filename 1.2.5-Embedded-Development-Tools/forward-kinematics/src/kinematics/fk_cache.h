@@ -0,0 +1,91 @@
+#ifndef __KINEMATICS_FK_CACHE__
+#define __KINEMATICS_FK_CACHE__
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "robot_model.h"
+
+namespace kinematics {
+	// Longest chain the cache keys hold; keeps an entry at one cache line
+	const int MAX_CACHE_JOINTS = 6;
+	// Slots probed for a key, starting at its hash
+	const int CACHE_WAYS = 8;
+
+	typedef struct FkCacheStats {
+		long hits;      // lookups answered from the cache
+		long misses;    // lookups that had to compute FK
+		long inserts;   // results stored
+		long evictions; // inserts that replaced another configuration
+		long entries;   // slots in use
+	} FkCacheStats;
+
+	// End-effector transforms keyed by joint angles snapped to a grid, e.g. the driver's
+	// whole servo degrees. Fixed capacity and open addressing within a window of CACHE_WAYS
+	// slots. LRU is approximated by second-chance (CLOCK) eviction inside that window, so
+	// recently used configurations stay without keeping a global recency order.
+	// Reads are lock-free: each entry carries a sequence counter that is odd while it is
+	// being written, and a reader retries if the counter moved under it (a seqlock). Only
+	// inserts take the lock of their shard, so writers contend only within a shard.
+	// The model must outlive the cache.
+	class FkCache {
+	public:
+		// capacity is rounded up to a power of two; step is the grid spacing, rad
+		FkCache(const RobotModel &model, long capacity, float step = (float)(M_PI / 180.0), int n_shards = 16);
+
+		// FK at the joint angles snapped to the grid, from the cache if it holds them
+		void fk(const float *thetas, linalg::Transform &out);
+		// The cached transform without computing on a miss; false if absent
+		bool lookup(const float *thetas, linalg::Transform &out);
+
+		float step() const { return step_; }
+		long capacity() const { return (long)n_shards_ * slots_per_shard_; }
+		// Summed over the shards
+		FkCacheStats stats() const;
+		float hitRate() const;
+		void resetStats();
+		// Empty the cache, e.g. after the model changed
+		void clear();
+
+	private:
+		typedef struct alignas(64) Entry {
+			// Odd while a writer holds the entry; 16 bits, as a reader would have to stall
+			// for 32768 rewrites of one slot to miss a change
+			std::atomic<uint16_t> seq;
+			uint8_t used;
+			// Second-chance bit, set on every hit and cleared as the insert scan passes it
+			std::atomic<uint8_t> referenced;
+			int16_t key[MAX_CACHE_JOINTS];
+			linalg::Transform T;
+		} Entry;
+
+		typedef struct alignas(64) Shard {
+			// Taken by inserts only
+			std::mutex mutex;
+			std::atomic<long> hits, misses;
+			long inserts, evictions, entries;
+		} Shard;
+
+		// Key of thetas and its hash
+		uint64_t quantize(const float *thetas, int16_t *key) const;
+		// Copies the transform stored for key into out without locking; false if absent
+		bool read(const Entry *shard_entries, uint64_t hash, const int16_t *key, linalg::Transform &out) const;
+		// Shard's slot holding key, nullptr if absent; call with the shard locked
+		Entry *find(Entry *shard_entries, uint64_t hash, const int16_t *key) const;
+		void insert(Shard &shard, Entry *shard_entries, uint64_t hash, const int16_t *key, const linalg::Transform &T);
+		// Seqlock write of an entry's fields; call with the shard locked
+		void store(Entry &e, const int16_t *key, uint8_t used, const linalg::Transform *T);
+
+		const RobotModel *model_;
+		int n_joints_;
+		float step_, inv_step_;
+		int n_shards_;
+		long slots_per_shard_;
+		std::unique_ptr<Shard[]> shards_;
+		std::unique_ptr<Entry[]> entries_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK_CACHE__*/
@@ -0,0 +1,70 @@
+#include "fk_scan.h"
+#include <omp.h>
+
+void kinematics::fkLinkFrames(const RobotModel &model, const float *thetas, linalg::Transform *frames, linalg::Transform &out) {
+	const int n = model.nJoints();
+	linalg::Transform E;
+	expScrew(model.screw(0), thetas[0], frames[0]);
+	for (int i = 1; i < n; i++) {
+		expScrew(model.screw(i), thetas[i], E);
+		frames[i] = linalg::compose(frames[i - 1], E);
+	}
+	out = linalg::compose(frames[n - 1], model.home());
+}
+
+void kinematics::fkScan(const RobotModel &model, const float *thetas, linalg::Transform *frames, linalg::Transform &out,
+			int n_threads) {
+	const int n = model.nJoints();
+	int max_blocks = n / SCAN_MIN_BLOCK;
+	int blocks = n_threads > 0 ? n_threads : omp_get_max_threads();
+	blocks = blocks < max_blocks ? blocks : max_blocks;
+	if (blocks < 2) {
+		fkLinkFrames(model, thetas, frames, out);
+		return;
+	}
+	// One total per block, at most MAX_JOINTS / SCAN_MIN_BLOCK of them
+	linalg::Transform block_total[MAX_JOINTS / SCAN_MIN_BLOCK];
+	#pragma omp parallel num_threads(blocks)
+	{
+		const int b = omp_get_thread_num();
+		const int nb = omp_get_num_threads();
+		const int lo = (int)((long)n * b / nb);
+		const int hi = (int)((long)n * (b + 1) / nb);
+		// Local scan of the block
+		linalg::Transform E;
+		expScrew(model.screw(lo), thetas[lo], frames[lo]);
+		for (int i = lo + 1; i < hi; i++) {
+			expScrew(model.screw(i), thetas[i], E);
+			frames[i] = linalg::compose(frames[i - 1], E);
+		}
+		block_total[b] = frames[hi - 1];
+		#pragma omp barrier
+		// The offset of block b is the product of the totals of blocks 0..b-1; there are
+		// only a handful, so every thread folds them itself instead of a second scan level
+		if (b > 0) {
+			linalg::Transform offset = block_total[0];
+			for (int k = 1; k < b; k++) {
+				offset = linalg::compose(offset, block_total[k]);
+			}
+			for (int i = lo; i < hi; i++) {
+				frames[i] = linalg::compose(offset, frames[i]);
+			}
+		}
+	}
+	out = linalg::compose(frames[n - 1], model.home());
+}
+
+void kinematics::fkTreeReduce(const RobotModel &model, const float *thetas, linalg::Transform &out) {
+	const int n = model.nJoints();
+	linalg::Transform E[MAX_JOINTS];
+	for (int i = 0; i < n; i++) {
+		expScrew(model.screw(i), thetas[i], E[i]);
+	}
+	// Level by level, E[i] = E[i] * E[i + stride]; composition order is preserved so only associativity is used
+	for (int stride = 1; stride < n; stride *= 2) {
+		for (int i = 0; i + stride < n; i += 2 * stride) {
+			E[i] = linalg::compose(E[i], E[i + stride]);
+		}
+	}
+	out = linalg::compose(E[0], model.home());
+}
@@ -0,0 +1,29 @@
+#ifndef __KINEMATICS_FK_SCAN__
+#define __KINEMATICS_FK_SCAN__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// Minimum joints per thread before fkScan() goes parallel; shorter blocks
+	// cost more in fork/join and the offset pass than they save
+	const int SCAN_MIN_BLOCK = 8;
+
+	// Link frames of the chain: frames[i] = e^([S1] theta1) * ... * e^([S(i+1)] theta(i+1)),
+	// out = frames[n - 1] * M. Plain left-to-right product, the reference for the modes below.
+	void fkLinkFrames(const RobotModel &model, const float *thetas, linalg::Transform *frames, linalg::Transform &out);
+
+	// Same frames as a blocked parallel prefix over OpenMP threads, using the
+	// associativity of composition: every thread scans its block of joints, then
+	// left-multiplies its frames by the product of the earlier blocks' totals.
+	// n_threads <= 0 uses omp_get_max_threads(); at most nJoints() / SCAN_MIN_BLOCK threads are used.
+	void fkScan(const RobotModel &model, const float *thetas, linalg::Transform *frames, linalg::Transform &out,
+		    int n_threads = 0);
+
+	// End-effector pose only, as a pairwise tree reduction of the exponentials:
+	// log2(n) dependent compositions instead of n, and the independent ones at
+	// each level are free to overlap in the pipeline. No threads.
+	void fkTreeReduce(const RobotModel &model, const float *thetas, linalg::Transform &out);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK_SCAN__*/
@@ -0,0 +1,101 @@
+#include "fk_simd.h"
+#include <cmath>
+
+// out = e^([S] theta) for every lane, same formulas as expScrew()
+static inline void expScrewLanes(const kinematics::Screw &S, const float *theta, kinematics::TransformBatch &out) {
+	float s[kinematics::FK_LANES], a[kinematics::FK_LANES], b[kinematics::FK_LANES];
+	#pragma omp simd
+	for (int l = 0; l < kinematics::FK_LANES; l++) {
+		float c;
+		kinematics::sinCosLanes(theta[l], s[l], c);
+		a[l] = 1.0f - c;
+		b[l] = theta[l] - s[l];
+	}
+	float G[9][kinematics::FK_LANES];
+	for (int k = 0; k < 9; k++) {
+		float diag = (k % 4 == 0) ? 1.0f : 0.0f;
+		#pragma omp simd
+		for (int l = 0; l < kinematics::FK_LANES; l++) {
+			out.R[k][l] = S.W.m[k] * s[l] + S.W2.m[k] * a[l] + diag;
+			G[k][l] = S.W.m[k] * a[l] + S.W2.m[k] * b[l] + diag * theta[l];
+		}
+	}
+	for (int r = 0; r < 3; r++) {
+		#pragma omp simd
+		for (int l = 0; l < kinematics::FK_LANES; l++) {
+			out.p[r][l] = G[r * 3][l] * S.v.x + G[r * 3 + 1][l] * S.v.y + G[r * 3 + 2][l] * S.v.z;
+		}
+	}
+}
+
+// C = A * B lane-wise; C must not alias A or B
+static inline void composeLanes(const kinematics::TransformBatch &A, const kinematics::TransformBatch &B, kinematics::TransformBatch &C) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			#pragma omp simd
+			for (int l = 0; l < kinematics::FK_LANES; l++) {
+				C.R[i * 3 + j][l] = A.R[i * 3][l] * B.R[j][l] + A.R[i * 3 + 1][l] * B.R[3 + j][l] + A.R[i * 3 + 2][l] * B.R[6 + j][l];
+			}
+		}
+		#pragma omp simd
+		for (int l = 0; l < kinematics::FK_LANES; l++) {
+			C.p[i][l] = A.R[i * 3][l] * B.p[0][l] + A.R[i * 3 + 1][l] * B.p[1][l] + A.R[i * 3 + 2][l] * B.p[2][l] + A.p[i][l];
+		}
+	}
+}
+
+// C = A * M with the same M broadcast to every lane
+static inline void composeConstLanes(const kinematics::TransformBatch &A, const linalg::Transform &M, kinematics::TransformBatch &C) {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			#pragma omp simd
+			for (int l = 0; l < kinematics::FK_LANES; l++) {
+				C.R[i * 3 + j][l] = A.R[i * 3][l] * M.R.m[j] + A.R[i * 3 + 1][l] * M.R.m[3 + j] + A.R[i * 3 + 2][l] * M.R.m[6 + j];
+			}
+		}
+		#pragma omp simd
+		for (int l = 0; l < kinematics::FK_LANES; l++) {
+			C.p[i][l] = A.R[i * 3][l] * M.p.x + A.R[i * 3 + 1][l] * M.p.y + A.R[i * 3 + 2][l] * M.p.z + A.p[i][l];
+		}
+	}
+}
+
+void kinematics::fkLanes(const RobotModel &model, const float *thetas, TransformBatch &out) {
+	// Ping-pong between two running products to avoid copying after each compose
+	TransformBatch T[2], E;
+	int cur = 0;
+	expScrewLanes(model.screw(0), thetas, T[cur]);
+	for (int i = 1; i < model.nJoints(); i++) {
+		expScrewLanes(model.screw(i), thetas + i * FK_LANES, E);
+		composeLanes(T[cur], E, T[1 - cur]);
+		cur = 1 - cur;
+	}
+	composeConstLanes(T[cur], model.home(), out);
+}
+
+void kinematics::fkLanesFrames(const RobotModel &model, const float *thetas, TransformBatch *frames, TransformBatch &out) {
+	TransformBatch E;
+	expScrewLanes(model.screw(0), thetas, frames[0]);
+	for (int i = 1; i < model.nJoints(); i++) {
+		expScrewLanes(model.screw(i), thetas + i * FK_LANES, E);
+		composeLanes(frames[i - 1], E, frames[i]);
+	}
+	composeConstLanes(frames[model.nJoints() - 1], model.home(), out);
+}
+
+void kinematics::fkLanesBatch(const RobotModel &model, const float *thetas, TransformBatch *out, long n_blocks) {
+	const long block_size = (long)model.nJoints() * FK_LANES;
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < n_blocks; i++) {
+		fkLanes(model, thetas + i * block_size, out[i]);
+	}
+}
+
+linalg::Transform kinematics::extractLane(const TransformBatch &batch, int lane) {
+	linalg::Transform T;
+	for (int k = 0; k < 9; k++) {
+		T.R.m[k] = batch.R[k][lane];
+	}
+	T.p = linalg::Vec3{batch.p[0][lane], batch.p[1][lane], batch.p[2][lane]};
+	return T;
+}
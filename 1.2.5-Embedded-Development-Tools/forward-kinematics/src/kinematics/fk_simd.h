@@ -0,0 +1,55 @@
+#ifndef __KINEMATICS_FK_SIMD__
+#define __KINEMATICS_FK_SIMD__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// Number of configurations evaluated together, one per SIMD lane
+#if defined(__AVX2__)
+	const int FK_LANES = 8;
+#else
+	const int FK_LANES = 4; // NEON, SSE
+#endif
+
+	// sin(x) and cos(x) from polynomials only, so loops over lanes vectorize without libm's
+	// vector variants (which GCC only uses under -ffast-math). x is reduced around the nearest
+	// multiple of pi/2 with a three-part pi/2 (Cody-Waite), then Cephes' single-precision
+	// minimax polynomials on [-pi/4, pi/4] give a few ulp of error for |x| < 8192.
+	inline void sinCosLanes(float x, float &s, float &c) {
+		int n = (int)(x * 0.63661977f + (x >= 0.0f ? 0.5f : -0.5f));
+		float fn = (float)n;
+		float r = ((x - fn * 1.5703125f) - fn * 4.837512969970703125e-4f) - fn * 7.54978995489188216e-8f;
+		float r2 = r * r;
+		float sin_r = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+		float cos_r = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+		// Quadrant n mod 4: (sin, cos) = (S, C), (C, -S), (-S, -C), (-C, S)
+		bool swap = (n & 1) != 0;
+		float s_q = swap ? cos_r : sin_r;
+		float c_q = swap ? sin_r : cos_r;
+		s = (n & 2) != 0 ? -s_q : s_q;
+		c = ((n + 1) & 2) != 0 ? -c_q : c_q;
+	}
+
+	// FK_LANES transforms in SoA layout: R[k][lane] is entry k (row-major) of lane's rotation
+	struct alignas(32) TransformBatch {
+		float R[9][FK_LANES];
+		float p[3][FK_LANES];
+	};
+
+	// FK for FK_LANES configurations at once. thetas is SoA: thetas[j * FK_LANES + lane]
+	// is joint j of configuration lane. Every lane runs the same instruction stream.
+	void fkLanes(const RobotModel &model, const float *thetas, TransformBatch &out);
+
+	// fkLanes() that also keeps every link frame: frames[i] is the running product
+	// e^([S1] theta1) * ... * e^([S(i+1)] theta(i+1)) of each lane, as in fkLinkFrames()
+	void fkLanesFrames(const RobotModel &model, const float *thetas, TransformBatch *frames, TransformBatch &out);
+
+	// fkLanes over n_blocks consecutive SoA blocks of FK_LANES configurations, split across OpenMP threads
+	void fkLanesBatch(const RobotModel &model, const float *thetas, TransformBatch *out, long n_blocks);
+
+	// Lane of a batch as a regular transform
+	linalg::Transform extractLane(const TransformBatch &batch, int lane);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK_SIMD__*/
@@ -0,0 +1,342 @@
+#include "fk_stream.h"
+#include "fk.h"
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Longest value appendFixed() writes, "%.7g" fallback included, plus a separator
+static const int TEXT_BYTES_PER_VALUE = 20;
+static const int VALUES_PER_POSE = 12;
+
+typedef struct StreamChunk {
+	long seq;
+	int count;
+	float *thetas;
+	linalg::Transform *poses;
+	char *bytes;
+	size_t n_bytes;
+} StreamChunk;
+
+// Blocking FIFO of chunk pointers with a fixed capacity. pop() returns false
+// once the queue is closed and drained.
+class ChunkQueue {
+public:
+	explicit ChunkQueue(int capacity) : items_(capacity), head_(0), size_(0), closed_(false) {}
+
+	void push(StreamChunk *chunk) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_full_.wait(lock, [this] { return size_ < (int)items_.size(); });
+		items_[(head_ + size_) % items_.size()] = chunk;
+		size_++;
+		not_empty_.notify_one();
+	}
+
+	bool pop(StreamChunk *&chunk) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_empty_.wait(lock, [this] { return size_ > 0 || closed_; });
+		if (size_ == 0) {
+			return false;
+		}
+		chunk = items_[head_];
+		head_ = (head_ + 1) % items_.size();
+		size_--;
+		not_full_.notify_one();
+		return true;
+	}
+
+	void close() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+		not_empty_.notify_all();
+	}
+
+private:
+	std::vector<StreamChunk *> items_;
+	int head_;
+	int size_;
+	bool closed_;
+	std::mutex mutex_;
+	std::condition_variable not_full_;
+	std::condition_variable not_empty_;
+};
+
+/*===================Reader===================*/
+
+typedef struct StreamReader {
+	FILE *file;
+	int n_joints;
+	kinematics::StreamFormat format;
+	// Binary input mapped in full, consumed sequentially
+	const float *mapped;
+	size_t mapped_size;
+	size_t mapped_samples;
+	size_t next_sample;
+	// Text input
+	char *line;
+	size_t line_capacity;
+	long line_number;
+} StreamReader;
+
+static void warnTrailingBytes(int n_joints) {
+	fprintf(stderr, "Warning: binary input is not a whole number of %d-joint samples, ignoring the trailing bytes.\n", n_joints);
+}
+
+static void openReader(StreamReader &reader, FILE *in, int n_joints, kinematics::StreamFormat format) {
+	reader = StreamReader{in, n_joints, format, nullptr, 0, 0, 0, nullptr, 0, 0};
+	struct stat st;
+	if (format != kinematics::STREAM_BINARY || fstat(fileno(in), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		return;
+	}
+	off_t offset = ftello(in);
+	void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+	if (map == MAP_FAILED || offset < 0 || offset % sizeof(float) != 0) {
+		if (map != MAP_FAILED) {
+			munmap(map, st.st_size);
+		}
+		return;
+	}
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+	reader.mapped = (const float *)map;
+	reader.mapped_size = st.st_size;
+	reader.next_sample = offset / sizeof(float) / n_joints;
+	reader.mapped_samples = st.st_size / sizeof(float) / n_joints;
+	if ((st.st_size - offset) % (sizeof(float) * n_joints) != 0) {
+		warnTrailingBytes(n_joints);
+	}
+}
+
+static void closeReader(StreamReader &reader) {
+	if (reader.mapped != nullptr) {
+		munmap((void *)reader.mapped, reader.mapped_size);
+	}
+	free(reader.line);
+}
+
+// Fills up to max_samples samples, returns how many were read (0 at the end of the input)
+static int readChunk(StreamReader &reader, float *thetas, int max_samples) {
+	const int n = reader.n_joints;
+	if (reader.mapped != nullptr) {
+		size_t left = reader.mapped_samples - reader.next_sample;
+		int count = left < (size_t)max_samples ? (int)left : max_samples;
+		memcpy(thetas, reader.mapped + reader.next_sample * n, (size_t)count * n * sizeof(float));
+		reader.next_sample += count;
+		return count;
+	}
+	if (reader.format == kinematics::STREAM_BINARY) {
+		// Count bytes rather than samples, so a short read at the end of a pipe shows a partial sample
+		size_t sample_bytes = sizeof(float) * n;
+		size_t bytes = fread(thetas, 1, sample_bytes * max_samples, reader.file);
+		if (bytes % sample_bytes != 0) {
+			warnTrailingBytes(n);
+		}
+		return (int)(bytes / sample_bytes);
+	}
+	int count = 0;
+	while (count < max_samples && getline(&reader.line, &reader.line_capacity, reader.file) != -1) {
+		reader.line_number++;
+		char *comment = strchr(reader.line, '#');
+		if (comment != nullptr) {
+			*comment = '\0';
+		}
+		char *cursor = reader.line;
+		float *sample = thetas + (size_t)count * n;
+		int values = 0;
+		while (true) {
+			char *end;
+			float value = strtof(cursor, &end);
+			if (end == cursor) {
+				break;
+			}
+			if (values < n) {
+				sample[values] = value;
+			}
+			values++;
+			cursor = end;
+		}
+		while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+			cursor++;
+		}
+		if (values == 0 && *cursor == '\0') {
+			// Blank or comment-only line
+			continue;
+		}
+		if (values != n || *cursor != '\0') {
+			fprintf(stderr, "Error: input line %ld: expected %d joint angles.\n", reader.line_number, n);
+			exit(EXIT_FAILURE);
+		}
+		count++;
+	}
+	return count;
+}
+
+/*===================FK stage===================*/
+
+// Appends value with 6 decimals, e.g. "-53.976580". printf("%f") dominates text
+// output otherwise; values too large for the integer path fall back to it.
+static char *appendFixed(char *cursor, float value) {
+	double v = value;
+	if (!(v > -1e9 && v < 1e9)) {
+		return cursor + sprintf(cursor, "%.7g", value);
+	}
+	if (v < 0) {
+		*cursor++ = '-';
+		v = -v;
+	}
+	long long scaled = (long long)(v * 1e6 + 0.5);
+	long long integer = scaled / 1000000;
+	long long fraction = scaled % 1000000;
+	char digits[20];
+	int n = 0;
+	do {
+		digits[n++] = (char)('0' + integer % 10);
+		integer /= 10;
+	} while (integer > 0);
+	while (n > 0) {
+		*cursor++ = digits[--n];
+	}
+	*cursor++ = '.';
+	for (int k = 5; k >= 0; k--) {
+		cursor[k] = (char)('0' + fraction % 10);
+		fraction /= 10;
+	}
+	return cursor + 6;
+}
+
+static void computeChunk(const kinematics::RobotModel &model, StreamChunk &chunk, kinematics::StreamFormat format) {
+	const int n = model.nJoints();
+	for (int i = 0; i < chunk.count; i++) {
+		kinematics::forwardKinematics(model, chunk.thetas + (size_t)i * n, chunk.poses[i]);
+	}
+	if (format == kinematics::STREAM_BINARY) {
+		chunk.n_bytes = (size_t)chunk.count * sizeof(linalg::Transform);
+		return;
+	}
+	// Formatting is the expensive part of text output, so it happens here in parallel rather than in the writer
+	char *cursor = chunk.bytes;
+	for (int i = 0; i < chunk.count; i++) {
+		const linalg::Transform &T = chunk.poses[i];
+		const float row_major[VALUES_PER_POSE] = {T.R.m[0], T.R.m[1], T.R.m[2], T.p.x,
+							  T.R.m[3], T.R.m[4], T.R.m[5], T.p.y,
+							  T.R.m[6], T.R.m[7], T.R.m[8], T.p.z};
+		for (int k = 0; k < VALUES_PER_POSE; k++) {
+			cursor = appendFixed(cursor, row_major[k]);
+			*cursor++ = k + 1 < VALUES_PER_POSE ? ' ' : '\n';
+		}
+	}
+	chunk.n_bytes = cursor - chunk.bytes;
+}
+
+kinematics::StreamStats kinematics::runFkStream(const RobotModel &model, FILE *in, FILE *out, const StreamOptions &options) {
+	if (options.chunk_samples < 1 || options.queue_chunks < 2) {
+		fprintf(stderr, "Error: a stream needs at least 1 sample per chunk and 2 chunks, got %d and %d.\n",
+			options.chunk_samples, options.queue_chunks);
+		exit(EXIT_FAILURE);
+	}
+	const int n_joints = model.nJoints();
+	const int n_chunks = options.queue_chunks;
+	const size_t max_samples = options.chunk_samples;
+	int n_workers = options.fk_threads > 0 ? options.fk_threads : (int)std::thread::hardware_concurrency();
+	n_workers = n_workers > 0 ? n_workers : 1;
+
+	// The whole pool is allocated up front; nothing else grows with the input
+	std::vector<StreamChunk> pool(n_chunks);
+	size_t text_bytes = max_samples * VALUES_PER_POSE * TEXT_BYTES_PER_VALUE;
+	for (StreamChunk &chunk : pool) {
+		chunk.thetas = (float *)malloc(max_samples * n_joints * sizeof(float));
+		chunk.poses = (linalg::Transform *)malloc(max_samples * sizeof(linalg::Transform));
+		// Binary output is written straight from the poses
+		chunk.bytes = options.output_format == STREAM_TEXT ? (char *)malloc(text_bytes) : (char *)chunk.poses;
+		if (chunk.thetas == nullptr || chunk.poses == nullptr || chunk.bytes == nullptr) {
+			fprintf(stderr, "Error: failed to allocate the stream buffers.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	ChunkQueue free_chunks(n_chunks), to_fk(n_chunks), to_writer(n_chunks);
+	for (StreamChunk &chunk : pool) {
+		free_chunks.push(&chunk);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	long total_samples = 0;
+	long total_chunks = 0;
+
+	std::thread reader_thread([&] {
+		StreamReader reader;
+		openReader(reader, in, n_joints, options.input_format);
+		for (long seq = 0;; seq++) {
+			StreamChunk *chunk = nullptr;
+			free_chunks.pop(chunk);
+			chunk->seq = seq;
+			chunk->count = readChunk(reader, chunk->thetas, (int)max_samples);
+			if (chunk->count == 0) {
+				free_chunks.push(chunk);
+				break;
+			}
+			to_fk.push(chunk);
+		}
+		closeReader(reader);
+		to_fk.close();
+	});
+
+	std::atomic<int> workers_left(n_workers);
+	std::vector<std::thread> workers;
+	for (int w = 0; w < n_workers; w++) {
+		workers.emplace_back([&] {
+			// Per-thread copy of the model, like fkBatch()
+			RobotModel local = model;
+			StreamChunk *chunk = nullptr;
+			while (to_fk.pop(chunk)) {
+				computeChunk(local, *chunk, options.output_format);
+				to_writer.push(chunk);
+			}
+			if (--workers_left == 0) {
+				to_writer.close();
+			}
+		});
+	}
+
+	// Writer on the calling thread. Chunks finish out of order; the ones ahead of
+	// the next sequence number wait in a reorder slot, at most one per pool chunk.
+	std::vector<StreamChunk *> pending(n_chunks, nullptr);
+	long next_seq = 0;
+	StreamChunk *chunk = nullptr;
+	while (to_writer.pop(chunk)) {
+		pending[chunk->seq % n_chunks] = chunk;
+		while (pending[next_seq % n_chunks] != nullptr && pending[next_seq % n_chunks]->seq == next_seq) {
+			StreamChunk *ready = pending[next_seq % n_chunks];
+			pending[next_seq % n_chunks] = nullptr;
+			if (fwrite(ready->bytes, 1, ready->n_bytes, out) != ready->n_bytes) {
+				fprintf(stderr, "Error: failed to write the FK output.\n");
+				exit(EXIT_FAILURE);
+			}
+			total_samples += ready->count;
+			total_chunks++;
+			next_seq++;
+			free_chunks.push(ready);
+		}
+	}
+	fflush(out);
+
+	reader_thread.join();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	for (StreamChunk &c : pool) {
+		if (c.bytes != (char *)c.poses) {
+			free(c.bytes);
+		}
+		free(c.thetas);
+		free(c.poses);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return StreamStats{total_samples, total_chunks, seconds, seconds > 0 ? total_samples / seconds : 0.0};
+}
@@ -0,0 +1,43 @@
+#ifndef __KINEMATICS_FK_STREAM__
+#define __KINEMATICS_FK_STREAM__
+
+#include <stdio.h>
+#include "robot_model.h"
+
+namespace kinematics {
+	typedef enum StreamFormat {
+		// One sample per line, nJoints() whitespace-separated angles in radians; '#' starts a comment.
+		// Output lines are the top 3x4 rows of the pose, row-major, with 6 decimals.
+		STREAM_TEXT,
+		// Raw native-endian float32: nJoints() angles per input sample,
+		// 12 values per output pose (R row-major, then p), i.e. linalg::Transform as is
+		STREAM_BINARY
+	} StreamFormat;
+
+	typedef struct StreamOptions {
+		StreamFormat input_format = STREAM_TEXT;
+		StreamFormat output_format = STREAM_TEXT;
+		// Samples per chunk and number of chunks in flight; memory use is fixed by their product
+		int chunk_samples = 4096;
+		int queue_chunks = 8;
+		// FK worker threads, <= 0 for one per core
+		int fk_threads = 0;
+	} StreamOptions;
+
+	typedef struct StreamStats {
+		long samples;
+		long chunks;
+		double seconds;
+		double samples_per_second;
+	} StreamStats;
+
+	// Three-stage pipeline: a reader fills chunks of joint angles (a binary input that is
+	// a regular file is mmap'ed instead of read), FK workers compute and format the poses
+	// of whole chunks in parallel, and a writer emits the chunks in input order.
+	// Chunks come from a fixed pool and travel through bounded queues, so memory stays
+	// constant however long the input is. Exits with an error message on malformed input.
+	StreamStats runFkStream(const RobotModel &model, FILE *in, FILE *out, const StreamOptions &options);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_FK_STREAM__*/
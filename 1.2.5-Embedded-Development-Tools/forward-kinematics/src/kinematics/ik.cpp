@@ -0,0 +1,193 @@
+#include "ik.h"
+#include "jacobian.h"
+#include <time.h>
+
+static long nowNs() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Solves A x = b in place for a symmetric positive definite 6x6 A (Cholesky), x is left in b
+static void choleskySolve6(float *A, float *b) {
+	for (int j = 0; j < 6; j++) {
+		float d = A[j * 6 + j];
+		for (int k = 0; k < j; k++) {
+			d -= A[j * 6 + k] * A[j * 6 + k];
+		}
+		d = sqrtf(d > 1e-12f ? d : 1e-12f);
+		A[j * 6 + j] = d;
+		for (int i = j + 1; i < 6; i++) {
+			float s = A[i * 6 + j];
+			for (int k = 0; k < j; k++) {
+				s -= A[i * 6 + k] * A[j * 6 + k];
+			}
+			A[i * 6 + j] = s / d;
+		}
+	}
+	// L y = b, then L^T x = y
+	for (int i = 0; i < 6; i++) {
+		for (int k = 0; k < i; k++) {
+			b[i] -= A[i * 6 + k] * b[k];
+		}
+		b[i] /= A[i * 6 + i];
+	}
+	for (int i = 5; i >= 0; i--) {
+		for (int k = i + 1; k < 6; k++) {
+			b[i] -= A[k * 6 + i] * b[k];
+		}
+		b[i] /= A[i * 6 + i];
+	}
+}
+
+// Current iterate: pose error e (weighted rotation rows first) and the matching 6 x n Jacobian rows
+typedef struct IkState {
+	float thetas[kinematics::MAX_JOINTS];
+	float e[6];
+	float J[6][kinematics::MAX_JOINTS];
+	float cost;
+	float position_error;
+	float orientation_error;
+} IkState;
+
+static void evaluate(const kinematics::RobotModel &model, const kinematics::IkOptions &options,
+		     const linalg::Transform &target, IkState &state) {
+	const int n = model.nJoints();
+	linalg::Transform T;
+	kinematics::Twist Js[kinematics::MAX_JOINTS];
+	kinematics::fkWithJacobian(model, state.thetas, T, Js);
+
+	// Space-frame rotation error and position error of the end-effector point
+	linalg::Vec3 e_w = linalg::logSO3(linalg::mat3Mul(target.R, linalg::mat3Transpose(T.R)));
+	linalg::Vec3 e_p = target.p - T.p;
+	float w = options.use_orientation ? options.orientation_weight : 0.0f;
+	state.e[0] = w * e_w.x;
+	state.e[1] = w * e_w.y;
+	state.e[2] = w * e_w.z;
+	state.e[3] = e_p.x;
+	state.e[4] = e_p.y;
+	state.e[5] = e_p.z;
+	// Rows: angular velocity w_i and velocity of the end-effector point v_i + w_i x p
+	for (int i = 0; i < n; i++) {
+		linalg::Vec3 v = Js[i].v + linalg::cross(Js[i].w, T.p);
+		state.J[0][i] = w * Js[i].w.x;
+		state.J[1][i] = w * Js[i].w.y;
+		state.J[2][i] = w * Js[i].w.z;
+		state.J[3][i] = v.x;
+		state.J[4][i] = v.y;
+		state.J[5][i] = v.z;
+	}
+	state.cost = 0;
+	for (int r = 0; r < 6; r++) {
+		state.cost += state.e[r] * state.e[r];
+	}
+	state.position_error = linalg::norm(e_p);
+	state.orientation_error = options.use_orientation ? linalg::norm(e_w) : 0.0f;
+}
+
+static bool withinTolerance(const kinematics::IkOptions &options, const IkState &state) {
+	return state.position_error < options.position_tolerance && state.orientation_error < options.orientation_tolerance;
+}
+
+kinematics::IkSolver::IkSolver(const RobotModel &model, const IkOptions &options) : model_(&model), options_(options) {
+	for (int i = 0; i < model.nJoints(); i++) {
+		last_[i] = 0.5f * (model.jointLower(i) + model.jointUpper(i));
+	}
+}
+
+void kinematics::IkSolver::seed(const float *thetas) {
+	for (int i = 0; i < model_->nJoints(); i++) {
+		last_[i] = thetas[i];
+	}
+}
+
+kinematics::IkResult kinematics::IkSolver::solve(const linalg::Transform &target, float *thetas_out) {
+	long start = nowNs();
+	const int n = model_->nJoints();
+	IkState states[2];
+	int cur = 0;
+	for (int i = 0; i < n; i++) {
+		states[cur].thetas[i] = last_[i];
+	}
+	evaluate(*model_, options_, target, states[cur]);
+
+	float damping = options_.initial_damping;
+	IkResult result;
+	result.converged = false;
+	result.iterations = 0;
+	while (result.iterations < options_.max_iterations) {
+		IkState &s = states[cur];
+		if (withinTolerance(options_, s)) {
+			break;
+		}
+		result.iterations++;
+
+		// (J J^T + lambda I) y = e, dtheta = J^T y
+		float A[36];
+		float trace = 0;
+		for (int r = 0; r < 6; r++) {
+			for (int c = 0; c <= r; c++) {
+				float sum = 0;
+				for (int i = 0; i < n; i++) {
+					sum += s.J[r][i] * s.J[c][i];
+				}
+				A[r * 6 + c] = sum;
+				A[c * 6 + r] = sum;
+			}
+			trace += A[r * 6 + r];
+		}
+		float lambda = damping * (trace / 6.0f) + 1e-6f;
+		for (int r = 0; r < 6; r++) {
+			A[r * 6 + r] += lambda;
+		}
+		float y[6] = {s.e[0], s.e[1], s.e[2], s.e[3], s.e[4], s.e[5]};
+		choleskySolve6(A, y);
+
+		// Scale the step down uniformly if any joint would move more than max_step
+		float dtheta[MAX_JOINTS];
+		float largest = 0;
+		for (int i = 0; i < n; i++) {
+			dtheta[i] = 0;
+			for (int r = 0; r < 6; r++) {
+				dtheta[i] += s.J[r][i] * y[r];
+			}
+			float mag = fabsf(dtheta[i]);
+			largest = mag > largest ? mag : largest;
+		}
+		float scale = largest > options_.max_step ? options_.max_step / largest : 1.0f;
+
+		IkState &candidate = states[1 - cur];
+		for (int i = 0; i < n; i++) {
+			float theta = s.thetas[i] + scale * dtheta[i];
+			theta = theta < model_->jointLower(i) ? model_->jointLower(i) : theta;
+			theta = theta > model_->jointUpper(i) ? model_->jointUpper(i) : theta;
+			candidate.thetas[i] = theta;
+		}
+		evaluate(*model_, options_, target, candidate);
+
+		// Levenberg-Marquardt: accept improvements and trust the linearization more, else damp harder
+		if (candidate.cost < s.cost) {
+			cur = 1 - cur;
+			damping = damping * 0.3f > 1e-7f ? damping * 0.3f : 1e-7f;
+		} else {
+			damping *= 10.0f;
+			if (damping > 1e6f) {
+				// Stuck at a local minimum or an unreachable target
+				break;
+			}
+		}
+	}
+
+	// Judge the final accepted state, which the loop may have left on its last
+	// iteration or on the damping limit without checking
+	const IkState &best = states[cur];
+	result.converged = withinTolerance(options_, best);
+	for (int i = 0; i < n; i++) {
+		thetas_out[i] = best.thetas[i];
+		last_[i] = best.thetas[i];
+	}
+	result.position_error = best.position_error;
+	result.orientation_error = best.orientation_error;
+	result.time_ns = nowNs() - start;
+	return result;
+}
@@ -0,0 +1,53 @@
+#ifndef __KINEMATICS_IK__
+#define __KINEMATICS_IK__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	typedef struct IkOptions {
+		int max_iterations = 100;
+		float position_tolerance = 0.01f;     // mm
+		float orientation_tolerance = 1e-3f;  // rad
+		// Scales rotation errors (rad) against position errors (mm)
+		float orientation_weight = 100.0f;
+		// Set to false to only solve for the end-effector position
+		bool use_orientation = true;
+		// Largest change of any joint in one iteration, rad
+		float max_step = 0.5f;
+		// Levenberg-Marquardt damping, relative to the mean diagonal of J J^T
+		float initial_damping = 1e-3f;
+	} IkOptions;
+
+	typedef struct IkResult {
+		bool converged;
+		int iterations;
+		float position_error;    // mm
+		float orientation_error; // rad
+		long time_ns;
+	} IkResult;
+
+	// Damped least-squares / Levenberg-Marquardt IK on the PoE model and space Jacobian.
+	// Makes no heap allocation. Each solve() starts from the previous solution,
+	// so tracking a smooth path usually converges in a few iterations.
+	// One instance per thread; the model must outlive it.
+	class IkSolver {
+	public:
+		explicit IkSolver(const RobotModel &model, const IkOptions &options = IkOptions());
+
+		// Warm start for the next solve(), e.g. the current joint readings
+		void seed(const float *thetas);
+		IkResult solve(const linalg::Transform &target, float *thetas_out);
+
+		const IkOptions &options() const { return options_; }
+		// Solution of the last solve(), or the seed
+		const float *lastSolution() const { return last_; }
+
+	private:
+		const RobotModel *model_;
+		IkOptions options_;
+		float last_[MAX_JOINTS];
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_IK__*/
@@ -0,0 +1,82 @@
+#include "incremental_fk.h"
+
+kinematics::IncrementalFk::IncrementalFk(const RobotModel &model) : model_(&model) {
+	invalidate();
+	resetStats();
+}
+
+void kinematics::IncrementalFk::invalidate() {
+	valid_ = false;
+}
+
+void kinematics::IncrementalFk::resetStats() {
+	stats_ = IncrementalFkStats{0, 0, 0, 0, 0, 0, 0};
+}
+
+float kinematics::IncrementalFk::hitRate() const {
+	long total = stats_.joints_reused + stats_.joints_recomputed;
+	return total > 0 ? (float)stats_.joints_reused / total : 0.0f;
+}
+
+void kinematics::IncrementalFk::update(const float *thetas, linalg::Transform &out) {
+	const int n = model_->nJoints();
+	stats_.updates++;
+
+	// Dirty window [lo, hi) that has to be recomputed and the new split inside it
+	int lo, hi, split;
+	if (!valid_) {
+		prefix_[0] = linalg::transformIdentity<float>();
+		suffix_[n] = linalg::transformIdentity<float>();
+		lo = 0;
+		hi = n;
+		split = n;
+		valid_ = true;
+	} else {
+		// Changed joints [changed_lo, changed_hi)
+		int changed_lo = 0;
+		while (changed_lo < n && thetas[changed_lo] == thetas_[changed_lo]) {
+			changed_lo++;
+		}
+		if (changed_lo == n) {
+			stats_.full_hits++;
+			stats_.joints_reused += n;
+			stats_.flops_saved += (long)n * FLOPS_PER_JOINT;
+			out = result_;
+			return;
+		}
+		int changed_hi = n;
+		while (thetas[changed_hi - 1] == thetas_[changed_hi - 1]) {
+			changed_hi--;
+		}
+		// Caches only reach up to the old split from either side
+		lo = changed_lo < split_ ? changed_lo : split_;
+		hi = changed_hi > split_ ? changed_hi : split_;
+		// Wrist-side changes go into the prefix, base-side changes into the suffix.
+		// Either way the split ends up next to the changed joints, so moving them
+		// again next tick only costs the changed joints.
+		split = (changed_lo + changed_hi >= n) ? changed_hi : changed_lo;
+	}
+
+	linalg::Transform E;
+	for (int i = lo; i < split; i++) {
+		thetas_[i] = thetas[i];
+		expScrew(model_->screw(i), thetas[i], E);
+		prefix_[i + 1] = linalg::compose(prefix_[i], E);
+	}
+	for (int i = hi - 1; i >= split; i--) {
+		thetas_[i] = thetas[i];
+		expScrew(model_->bodyScrew(i), thetas[i], E);
+		suffix_[i] = linalg::compose(E, suffix_[i + 1]);
+	}
+	split_ = split;
+	stats_.prefix_updates += (split > lo);
+	stats_.suffix_updates += (hi > split);
+
+	result_ = linalg::compose(linalg::compose(prefix_[split_], model_->home()), suffix_[split_]);
+	out = result_;
+
+	int reused = n - (hi - lo);
+	stats_.joints_reused += reused;
+	stats_.joints_recomputed += hi - lo;
+	stats_.flops_saved += (long)reused * FLOPS_PER_JOINT;
+}
@@ -0,0 +1,55 @@
+#ifndef __KINEMATICS_INCREMENTAL_FK__
+#define __KINEMATICS_INCREMENTAL_FK__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// Flops of one joint (exponential + compose onto the running product), sin/cos excluded
+	const int FLOPS_PER_JOINT = 138;
+
+	typedef struct IncrementalFkStats {
+		long updates;           // calls to update()
+		long full_hits;         // updates where no joint changed
+		long prefix_updates;    // updates served by extending the space-frame prefix cache
+		long suffix_updates;    // updates served by extending the body-frame suffix cache
+		long joints_reused;     // exponentials served from the caches
+		long joints_recomputed; // exponentials evaluated
+		long flops_saved;       // joints_reused * FLOPS_PER_JOINT
+	} IncrementalFkStats;
+
+	// FK state for incremental motion. Uses
+	//   T = e^([S1] theta1) ... e^([Sk] thetak) * M * e^([Bk+1] thetak+1) ... e^([Bn] thetan)
+	// for a split point k and caches the space-frame prefix products left of k
+	// and the body-frame suffix products right of k. On update() only the joints
+	// between the split and the changed joints are recomputed: wrist changes
+	// extend the prefix, base changes extend the suffix.
+	// One instance per thread; the model must outlive it.
+	class IncrementalFk {
+	public:
+		explicit IncrementalFk(const RobotModel &model);
+
+		void update(const float *thetas, linalg::Transform &out);
+		// Drop the cached products, e.g. after the model changed
+		void invalidate();
+
+		const IncrementalFkStats &stats() const { return stats_; }
+		// Fraction of joint exponentials served from the cache
+		float hitRate() const;
+		void resetStats();
+
+	private:
+		const RobotModel *model_;
+		float thetas_[MAX_JOINTS];
+		// prefix_[k] = e^([S1] theta1) * ... * e^([Sk] thetak), valid for k <= split_
+		linalg::Transform prefix_[MAX_JOINTS + 1];
+		// suffix_[k] = e^([Bk+1] thetak+1) * ... * e^([Bn] thetan), valid for k >= split_
+		linalg::Transform suffix_[MAX_JOINTS + 1];
+		linalg::Transform result_;
+		int split_;
+		bool valid_;
+		IncrementalFkStats stats_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_INCREMENTAL_FK__*/
@@ -0,0 +1,23 @@
+#include "jacobian.h"
+
+void kinematics::fkWithJacobian(const RobotModel &model, const float *thetas, linalg::Transform &T, Twist *J) {
+	// The first column is S_1 itself since the prefix before joint 1 is the identity
+	const Screw &S0 = model.screw(0);
+	J[0] = Twist{S0.w, S0.v};
+	linalg::Transform P, E;
+	expScrew(S0, thetas[0], P);
+	for (int i = 1; i < model.nJoints(); i++) {
+		const Screw &S = model.screw(i);
+		J[i] = adjoint(P, Twist{S.w, S.v});
+		expScrew(S, thetas[i], E);
+		P = linalg::compose(P, E);
+	}
+	T = linalg::compose(P, model.home());
+}
+
+void kinematics::bodyJacobian(const linalg::Transform &T, const Twist *Js, Twist *Jb, int n_joints) {
+	linalg::Transform T_inv = linalg::inverse(T);
+	for (int i = 0; i < n_joints; i++) {
+		Jb[i] = adjoint(T_inv, Js[i]);
+	}
+}
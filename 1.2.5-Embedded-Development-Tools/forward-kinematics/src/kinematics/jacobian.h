@@ -0,0 +1,17 @@
+#ifndef __KINEMATICS_JACOBIAN__
+#define __KINEMATICS_JACOBIAN__
+
+#include "robot_model.h"
+
+namespace kinematics {
+	// FK and the 6 x n space Jacobian in a single pass over the chain.
+	// J[i] is column i as a twist (omega, v): J[i] = [Ad_(e^([S1] theta1) ... e^([Si-1] thetai-1))] S_i,
+	// taken from the running product FK already builds.
+	void fkWithJacobian(const RobotModel &model, const float *thetas, linalg::Transform &T, Twist *J);
+
+	// Body Jacobian from the space Jacobian at pose T: Jb[i] = [Ad_T^-1] Js[i]. Jb may alias Js.
+	void bodyJacobian(const linalg::Transform &T, const Twist *Js, Twist *Jb, int n_joints);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_JACOBIAN__*/
@@ -0,0 +1,168 @@
+#ifndef __KINEMATICS_JOINT_TYPES__
+#define __KINEMATICS_JOINT_TYPES__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include "robot_model.h"
+
+namespace kinematics {
+	// Joint types with structure-specific exponentials. Each type provides
+	//   exp(theta, out):   out = e^([S] theta)
+	//   apply(theta, T):   T = T * e^([S] theta), touching only the entries the joint changes
+	// and JointChain composes them with the joint types fixed at compile time.
+
+	// Revolute joint about the principal axis K (0 = x, 1 = y, 2 = z) through a point.
+	// The rotation only mixes the two other columns of the running transform:
+	// apply() is 24 multiplies and 16 adds after sin/cos, against 138 flops for a general screw.
+	template <int K>
+	struct RevoluteAxis {
+		static_assert(K >= 0 && K < 3, "axis must be 0 (x), 1 (y) or 2 (z)");
+		static const int I = (K + 1) % 3;
+		static const int J = (K + 2) % 3;
+
+		linalg::Vec3 point;
+
+		static RevoluteAxis fromSpec(const JointSpec &spec, int index) {
+			const float axis[3] = {spec.omega.x, spec.omega.y, spec.omega.z};
+			if (fabsf(axis[K] - 1.0f) > 1e-6f || fabsf(axis[I]) > 1e-6f || fabsf(axis[J]) > 1e-6f) {
+				fprintf(stderr, "Error: joint %d is not a revolute joint about the %c axis.\n", index, "xyz"[K]);
+				exit(EXIT_FAILURE);
+			}
+			return RevoluteAxis{spec.point};
+		}
+
+		// e^([S] theta) = [Rot_K(theta), (I - Rot_K(theta)) q]
+		inline void exp(float theta, linalg::Transform &out) const {
+			float s = sinf(theta), c = cosf(theta);
+			const float q[3] = {point.x, point.y, point.z};
+			float *R = out.R.m;
+			R[K * 3 + K] = 1.0f;
+			R[K * 3 + I] = R[K * 3 + J] = R[I * 3 + K] = R[J * 3 + K] = 0.0f;
+			R[I * 3 + I] = c;
+			R[I * 3 + J] = -s;
+			R[J * 3 + I] = s;
+			R[J * 3 + J] = c;
+			float d[3];
+			d[K] = 0.0f;
+			d[I] = q[I] - c * q[I] + s * q[J];
+			d[J] = q[J] - s * q[I] - c * q[J];
+			out.p = linalg::Vec3{d[0], d[1], d[2]};
+		}
+
+		inline void apply(float theta, linalg::Transform &T) const {
+			float s = sinf(theta), c = cosf(theta);
+			const float q[3] = {point.x, point.y, point.z};
+			float di = q[I] - c * q[I] + s * q[J];
+			float dj = q[J] - s * q[I] - c * q[J];
+			float dp[3];
+			for (int r = 0; r < 3; r++) {
+				float ri = T.R.m[r * 3 + I], rj = T.R.m[r * 3 + J];
+				T.R.m[r * 3 + I] = c * ri + s * rj;
+				T.R.m[r * 3 + J] = c * rj - s * ri;
+				dp[r] = ri * di + rj * dj;
+			}
+			T.p = T.p + linalg::Vec3{dp[0], dp[1], dp[2]};
+		}
+	};
+	typedef RevoluteAxis<0> RevoluteX;
+	typedef RevoluteAxis<1> RevoluteY;
+	typedef RevoluteAxis<2> RevoluteZ;
+
+	// Revolute joint about an arbitrary axis: the dense screw exponential
+	struct RevoluteGeneral {
+		Screw screw;
+
+		static RevoluteGeneral fromSpec(const JointSpec &spec, int index) {
+			return RevoluteGeneral{makeScrew(spec)};
+		}
+
+		inline void exp(float theta, linalg::Transform &out) const {
+			expScrew(screw, theta, out);
+		}
+
+		inline void apply(float theta, linalg::Transform &T) const {
+			linalg::Transform E;
+			expScrew(screw, theta, E);
+			T = linalg::compose(T, E);
+		}
+	};
+
+	// Prismatic joint sliding theta along a unit direction: a pure translation,
+	// so apply() leaves the rotation alone and adds theta * R u to the position.
+	// JointSpec only describes revolute joints, so prismatic joints have no fromSpec().
+	struct Prismatic {
+		linalg::Vec3 direction;
+
+		inline void exp(float theta, linalg::Transform &out) const {
+			out.R = linalg::mat3Identity<float>();
+			out.p = direction * theta;
+		}
+
+		inline void apply(float theta, linalg::Transform &T) const {
+			T.p = T.p + linalg::mat3MulVec(T.R, direction * theta);
+		}
+	};
+
+	// Serial chain whose joint types are template arguments, so every joint's
+	// exponential is inlined with its own structure and no per-joint dispatch.
+	//   JointChain<RevoluteZ, RevoluteX, RevoluteX, RevoluteX> chain(M, ...);
+	//   chain.fk(thetas, T);
+	template <typename... Joints>
+	class JointChain {
+	public:
+		static const int N_JOINTS = sizeof...(Joints);
+		static_assert(N_JOINTS >= 1, "a chain needs at least one joint");
+
+		JointChain(const linalg::Transform &M, const Joints &...joints) : joints_(joints...), M_(M) {}
+
+		// Chain for a revolute RobotModel; exits if a joint does not match its declared type
+		static JointChain fromModel(const RobotModel &model) {
+			if (model.nJoints() != N_JOINTS) {
+				fprintf(stderr, "Error: a %d-joint chain cannot be built from a %d-joint model.\n", N_JOINTS, model.nJoints());
+				exit(EXIT_FAILURE);
+			}
+			return fromModel(model, std::index_sequence_for<Joints...>());
+		}
+
+		// out = e^([S1] theta1) * ... * e^([Sn] thetan) * M, same as forwardKinematics()
+		inline void fk(const float *thetas, linalg::Transform &out) const {
+			linalg::Transform T;
+			steps(thetas, T, std::index_sequence_for<Joints...>());
+			out = linalg::compose(T, M_);
+		}
+
+		template <size_t I>
+		const typename std::tuple_element<I, std::tuple<Joints...>>::type &joint() const { return std::get<I>(joints_); }
+		const linalg::Transform &home() const { return M_; }
+
+	private:
+		template <size_t... I>
+		static JointChain fromModel(const RobotModel &model, std::index_sequence<I...>) {
+			return JointChain(model.home(), Joints::fromSpec(model.jointSpec(I), I)...);
+		}
+
+		// The first exponential initializes the running product instead of multiplying by I
+		template <size_t I>
+		inline void step(const float *thetas, linalg::Transform &T) const {
+			if constexpr (I == 0) {
+				std::get<0>(joints_).exp(thetas[0], T);
+			} else {
+				std::get<I>(joints_).apply(thetas[I], T);
+			}
+		}
+
+		template <size_t... I>
+		inline void steps(const float *thetas, linalg::Transform &T, std::index_sequence<I...>) const {
+			(step<I>(thetas, T), ...);
+		}
+
+		std::tuple<Joints...> joints_;
+		linalg::Transform M_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_JOINT_TYPES__*/
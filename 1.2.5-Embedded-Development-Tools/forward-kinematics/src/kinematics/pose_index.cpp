@@ -0,0 +1,376 @@
+#include "pose_index.h"
+#include "fk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char INDEX_MAGIC[8] = {'F', 'K', 'P', 'O', 'S', 'E', 'I', 'X'};
+static const uint32_t INDEX_VERSION = 1;
+
+// Sections follow at 64-byte aligned offsets: keys, split axes, joint angles
+typedef struct alignas(64) IndexHeader {
+	char magic[8];
+	uint32_t version;
+	int32_t key_dim;
+	int32_t n_joints;
+	float orientation_weight;
+	int64_t n_entries;
+	uint64_t model_fingerprint;
+	int64_t total_size;
+} IndexHeader;
+
+static size_t align64(size_t x) {
+	return (x + 63) & ~(size_t)63;
+}
+
+typedef struct IndexLayout {
+	size_t keys, split, thetas, total;
+} IndexLayout;
+
+static IndexLayout layoutFor(long n, int key_dim, int n_joints) {
+	IndexLayout l;
+	l.keys = sizeof(IndexHeader);
+	l.split = align64(l.keys + (size_t)n * key_dim * sizeof(float));
+	l.thetas = align64(l.split + (size_t)n);
+	l.total = align64(l.thetas + (size_t)n * n_joints * sizeof(float));
+	return l;
+}
+
+// FNV-1a over the geometry and limits, to refuse an index built for another arm
+static uint64_t modelFingerprint(const kinematics::RobotModel &model) {
+	uint64_t h = 1469598103934665603ULL;
+	auto mix = [&h](float v) {
+		uint32_t bits;
+		memcpy(&bits, &v, sizeof(bits));
+		for (int b = 0; b < 4; b++) {
+			h = (h ^ ((bits >> (8 * b)) & 0xFF)) * 1099511628211ULL;
+		}
+	};
+	for (int i = 0; i < model.nJoints(); i++) {
+		const kinematics::JointSpec &s = model.jointSpec(i);
+		mix(s.omega.x); mix(s.omega.y); mix(s.omega.z);
+		mix(s.point.x); mix(s.point.y); mix(s.point.z);
+		mix(model.jointLower(i)); mix(model.jointUpper(i));
+	}
+	const linalg::Transform &M = model.home();
+	for (int k = 0; k < 9; k++) {
+		mix(M.R.m[k]);
+	}
+	mix(M.p.x); mix(M.p.y); mix(M.p.z);
+	return h;
+}
+
+kinematics::PoseIndex::PoseIndex()
+	: data_(nullptr), data_size_(0), mapped_(false), keys_(nullptr), split_(nullptr), thetas_(nullptr),
+	  n_(0), key_dim_(0), n_joints_(0), orientation_weight_(0) {}
+
+kinematics::PoseIndex::~PoseIndex() {
+	release();
+}
+
+void kinematics::PoseIndex::release() {
+	if (data_ != nullptr) {
+		if (mapped_) {
+			munmap(data_, data_size_);
+		} else {
+			free(data_);
+		}
+	}
+	data_ = nullptr;
+	data_size_ = 0;
+	mapped_ = false;
+	keys_ = nullptr;
+	split_ = nullptr;
+	thetas_ = nullptr;
+	n_ = 0;
+}
+
+void kinematics::PoseIndex::setLayout(char *base) {
+	const IndexHeader *header = (const IndexHeader *)base;
+	n_ = header->n_entries;
+	key_dim_ = header->key_dim;
+	n_joints_ = header->n_joints;
+	orientation_weight_ = header->orientation_weight;
+	IndexLayout l = layoutFor(n_, key_dim_, n_joints_);
+	keys_ = (const float *)(base + l.keys);
+	split_ = (const uint8_t *)(base + l.split);
+	thetas_ = (const float *)(base + l.thetas);
+}
+
+void kinematics::PoseIndex::key(const linalg::Transform &T, float *out) const {
+	out[0] = T.p.x;
+	out[1] = T.p.y;
+	out[2] = T.p.z;
+	if (key_dim_ == MAX_KEY_DIM) {
+		// First and third rotation columns; the second is their cross product
+		const float w = orientation_weight_;
+		out[3] = w * T.R.m[0];
+		out[4] = w * T.R.m[3];
+		out[5] = w * T.R.m[6];
+		out[6] = w * T.R.m[2];
+		out[7] = w * T.R.m[5];
+		out[8] = w * T.R.m[8];
+	}
+}
+
+linalg::Vec3 kinematics::PoseIndex::position(long id) const {
+	const float *k = keys_ + id * key_dim_;
+	return linalg::Vec3{k[0], k[1], k[2]};
+}
+
+/*===================Build===================*/
+
+// Orders perm[lo, hi) into an implicit k-d tree: the middle element splits the range
+// on the axis of largest spread, smaller keys to its left and larger to its right
+static void buildTree(const float *keys, int key_dim, long *perm, uint8_t *split, long lo, long hi) {
+	if (hi - lo < 2) {
+		if (hi > lo) {
+			split[lo] = 0;
+		}
+		return;
+	}
+	float min[kinematics::MAX_KEY_DIM], max[kinematics::MAX_KEY_DIM];
+	for (int d = 0; d < key_dim; d++) {
+		min[d] = max[d] = keys[perm[lo] * key_dim + d];
+	}
+	for (long i = lo + 1; i < hi; i++) {
+		const float *k = keys + perm[i] * key_dim;
+		for (int d = 0; d < key_dim; d++) {
+			min[d] = k[d] < min[d] ? k[d] : min[d];
+			max[d] = k[d] > max[d] ? k[d] : max[d];
+		}
+	}
+	int axis = 0;
+	for (int d = 1; d < key_dim; d++) {
+		axis = max[d] - min[d] > max[axis] - min[axis] ? d : axis;
+	}
+	long mid = lo + (hi - lo) / 2;
+	std::nth_element(perm + lo, perm + mid, perm + hi,
+			 [keys, key_dim, axis](long a, long b) { return keys[a * key_dim + axis] < keys[b * key_dim + axis]; });
+	split[mid] = (uint8_t)axis;
+	// Subtrees are independent; large ones become OpenMP tasks
+	#pragma omp task if (hi - lo > 65536)
+	buildTree(keys, key_dim, perm, split, lo, mid);
+	#pragma omp task if (hi - lo > 65536)
+	buildTree(keys, key_dim, perm, split, mid + 1, hi);
+	#pragma omp taskwait
+}
+
+void kinematics::PoseIndex::build(const RobotModel &model, const WorkspaceSamplingOptions &sampling, const PoseIndexOptions &options) {
+	release();
+	const long n = samplingCount(model, sampling);
+	const int n_joints = model.nJoints();
+	key_dim_ = options.use_orientation ? MAX_KEY_DIM : 3;
+	orientation_weight_ = options.orientation_weight;
+	n_joints_ = n_joints;
+
+	// Unordered samples first
+	std::vector<float> keys((size_t)n * key_dim_);
+	std::vector<float> thetas((size_t)n * n_joints);
+	#pragma omp parallel
+	{
+		RobotModel local = model;
+		linalg::Transform T;
+		#pragma omp for schedule(static)
+		for (long i = 0; i < n; i++) {
+			sampleConfiguration(local, sampling, i, &thetas[(size_t)i * n_joints]);
+			forwardKinematics(local, &thetas[(size_t)i * n_joints], T);
+			key(T, &keys[(size_t)i * key_dim_]);
+		}
+	}
+
+	IndexLayout l = layoutFor(n, key_dim_, n_joints);
+	data_ = (char *)aligned_alloc(64, l.total);
+	if (data_ == nullptr) {
+		fprintf(stderr, "Error: failed to allocate a pose index of %zu bytes.\n", l.total);
+		exit(EXIT_FAILURE);
+	}
+	memset(data_, 0, l.total);
+	data_size_ = l.total;
+	IndexHeader *header = (IndexHeader *)data_;
+	memcpy(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	header->version = INDEX_VERSION;
+	header->key_dim = key_dim_;
+	header->n_joints = n_joints;
+	header->orientation_weight = orientation_weight_;
+	header->n_entries = n;
+	header->model_fingerprint = modelFingerprint(model);
+	header->total_size = l.total;
+
+	std::vector<long> perm(n);
+	for (long i = 0; i < n; i++) {
+		perm[i] = i;
+	}
+	uint8_t *split = (uint8_t *)(data_ + l.split);
+	#pragma omp parallel
+	#pragma omp single
+	buildTree(keys.data(), key_dim_, perm.data(), split, 0, n);
+
+	// Entries in tree order
+	float *out_keys = (float *)(data_ + l.keys);
+	float *out_thetas = (float *)(data_ + l.thetas);
+	#pragma omp parallel for schedule(static)
+	for (long i = 0; i < n; i++) {
+		memcpy(out_keys + (size_t)i * key_dim_, &keys[(size_t)perm[i] * key_dim_], key_dim_ * sizeof(float));
+		memcpy(out_thetas + (size_t)i * n_joints, &thetas[(size_t)perm[i] * n_joints], n_joints * sizeof(float));
+	}
+	setLayout(data_);
+}
+
+/*===================Files===================*/
+
+bool kinematics::PoseIndex::write(const char *path) const {
+	if (data_ == nullptr) {
+		return false;
+	}
+	FILE *f = fopen(path, "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	bool ok = fwrite(data_, 1, data_size_, f) == data_size_;
+	return fclose(f) == 0 && ok;
+}
+
+bool kinematics::PoseIndex::map(const char *path, const RobotModel &model) {
+	release();
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(IndexHeader)) {
+		close(fd);
+		return false;
+	}
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+	const IndexHeader *header = (const IndexHeader *)mapping;
+	bool ok = memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 && header->version == INDEX_VERSION &&
+		  (header->key_dim == 3 || header->key_dim == MAX_KEY_DIM) && header->n_joints == model.nJoints() &&
+		  header->n_entries > 0 && header->model_fingerprint == modelFingerprint(model) &&
+		  header->total_size == st.st_size &&
+		  layoutFor(header->n_entries, header->key_dim, header->n_joints).total == (size_t)st.st_size;
+	if (!ok) {
+		munmap(mapping, st.st_size);
+		return false;
+	}
+	data_ = (char *)mapping;
+	data_size_ = st.st_size;
+	mapped_ = true;
+	setLayout(data_);
+	return true;
+}
+
+/*===================Queries===================*/
+
+namespace {
+	// k best so far, sorted nearest first
+	typedef struct Neighbours {
+		int k;
+		int count;
+		long ids[kinematics::MAX_NEIGHBOURS];
+		float dist2[kinematics::MAX_NEIGHBOURS];
+
+		float worst() const { return count < k ? 3.4e38f : dist2[count - 1]; }
+
+		void offer(long id, float d2) {
+			if (d2 >= worst()) {
+				return;
+			}
+			int i = count < k ? count++ : k - 1;
+			while (i > 0 && dist2[i - 1] > d2) {
+				ids[i] = ids[i - 1];
+				dist2[i] = dist2[i - 1];
+				i--;
+			}
+			ids[i] = id;
+			dist2[i] = d2;
+		}
+	} Neighbours;
+}
+
+static void searchTree(const float *keys, const uint8_t *split, int key_dim, const float *q, long lo, long hi, Neighbours &best) {
+	while (lo < hi) {
+		long mid = lo + (hi - lo) / 2;
+		const float *k = keys + mid * key_dim;
+		float d2 = 0;
+		for (int d = 0; d < key_dim; d++) {
+			float diff = q[d] - k[d];
+			d2 += diff * diff;
+		}
+		best.offer(mid, d2);
+		float diff = q[split[mid]] - k[split[mid]];
+		// Near side first so the k-th best shrinks early, then the far side only if the
+		// splitting plane is closer than the k-th best
+		if (diff < 0) {
+			searchTree(keys, split, key_dim, q, lo, mid, best);
+			lo = mid + 1;
+		} else {
+			searchTree(keys, split, key_dim, q, mid + 1, hi, best);
+			hi = mid;
+		}
+		if (diff * diff >= best.worst()) {
+			return;
+		}
+	}
+}
+
+int kinematics::PoseIndex::nearest(const linalg::Transform &target, int k, long *ids, float *dist2) const {
+	if (n_ == 0 || k < 1) {
+		return 0;
+	}
+	float q[MAX_KEY_DIM];
+	key(target, q);
+	Neighbours best;
+	best.k = k < MAX_NEIGHBOURS ? k : MAX_NEIGHBOURS;
+	best.count = 0;
+	searchTree(keys_, split_, key_dim_, q, 0, n_, best);
+	for (int i = 0; i < best.count; i++) {
+		ids[i] = best.ids[i];
+		if (dist2 != nullptr) {
+			dist2[i] = best.dist2[i];
+		}
+	}
+	return best.count;
+}
+
+kinematics::IkResult kinematics::solveFromIndex(const PoseIndex &index, IkSolver &solver, const linalg::Transform &target,
+						float *thetas_out, int candidates) {
+	long ids[MAX_NEIGHBOURS];
+	int found = index.nearest(target, candidates, ids);
+	IkResult best{false, 0, 3.4e38f, 3.4e38f, 0};
+	float best_thetas[MAX_JOINTS];
+	int total_iterations = 0;
+	long total_ns = 0;
+	for (int c = 0; c < found; c++) {
+		solver.seed(index.thetas(ids[c]));
+		IkResult r = solver.solve(target, thetas_out);
+		total_iterations += r.iterations;
+		total_ns += r.time_ns;
+		if (r.converged) {
+			r.iterations = total_iterations;
+			r.time_ns = total_ns;
+			return r;
+		}
+		if (r.position_error < best.position_error) {
+			best = r;
+			memcpy(best_thetas, thetas_out, index.nJoints() * sizeof(float));
+		}
+	}
+	if (found > 0) {
+		memcpy(thetas_out, best_thetas, index.nJoints() * sizeof(float));
+		solver.seed(best_thetas);
+	}
+	best.iterations = total_iterations;
+	best.time_ns = total_ns;
+	return best;
+}
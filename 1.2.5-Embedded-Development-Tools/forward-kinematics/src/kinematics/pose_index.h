@@ -0,0 +1,76 @@
+#ifndef __KINEMATICS_POSE_INDEX__
+#define __KINEMATICS_POSE_INDEX__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ik.h"
+#include "workspace.h"
+
+namespace kinematics {
+	// Largest k for nearest(); results are kept in a fixed array
+	const int MAX_NEIGHBOURS = 32;
+	// Position plus two scaled rotation columns
+	const int MAX_KEY_DIM = 9;
+
+	typedef struct PoseIndexOptions {
+		// Key on the full pose instead of the end-effector position only
+		bool use_orientation = true;
+		// Millimetres per unit of rotation-column difference, roughly mm per radian
+		float orientation_weight = 50.0f;
+	} PoseIndexOptions;
+
+	// Static k-d tree over FK samples of one arm, for seeding numerical IK.
+	// The tree is implicit: entries are stored in tree order, the root of any range
+	// [lo, hi) is its middle element, with keys, split axes and joint angles in three
+	// flat arrays. The same bytes are the file format, so a saved index is mmap'ed
+	// and queried in place without parsing.
+	class PoseIndex {
+	public:
+		PoseIndex();
+		~PoseIndex();
+		PoseIndex(const PoseIndex &) = delete;
+		PoseIndex &operator=(const PoseIndex &) = delete;
+
+		// FK over every configuration of the sampling options (OpenMP), then the tree build
+		void build(const RobotModel &model, const WorkspaceSamplingOptions &sampling,
+			   const PoseIndexOptions &options = PoseIndexOptions());
+		bool write(const char *path) const;
+		// Maps an index written for this model; false if the file is missing,
+		// malformed or was built for a different arm
+		bool map(const char *path, const RobotModel &model);
+		void release();
+
+		long size() const { return n_; }
+		int nJoints() const { return n_joints_; }
+		int keyDim() const { return key_dim_; }
+
+		// Up to k entries closest to target in key space, nearest first, without allocating.
+		// Returns how many were found; dist2 (optional) receives the squared key distances.
+		int nearest(const linalg::Transform &target, int k, long *ids, float *dist2 = nullptr) const;
+		const float *thetas(long id) const { return thetas_ + id * n_joints_; }
+		linalg::Vec3 position(long id) const;
+
+	private:
+		void key(const linalg::Transform &T, float *out) const;
+		void setLayout(char *base);
+
+		char *data_;
+		size_t data_size_;
+		bool mapped_;
+		const float *keys_;
+		const uint8_t *split_;
+		const float *thetas_;
+		long n_;
+		int key_dim_;
+		int n_joints_;
+		float orientation_weight_;
+	};
+
+	// Cold-start IK seeded from the index: tries the nearest candidates in turn and
+	// returns the first that converges, otherwise the closest attempt
+	IkResult solveFromIndex(const PoseIndex &index, IkSolver &solver, const linalg::Transform &target,
+				float *thetas_out, int candidates = 4);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_POSE_INDEX__*/
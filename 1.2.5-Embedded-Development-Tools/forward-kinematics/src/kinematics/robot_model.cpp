@@ -0,0 +1,50 @@
+#include "robot_model.h"
+#include "fk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+kinematics::RobotModel::RobotModel() : n_joints_(0) {
+	M_ = linalg::transformIdentity<float>();
+	memset(inertia_, 0, sizeof(inertia_));
+}
+
+kinematics::RobotModel::RobotModel(const JointSpec *joints, int n_joints, const linalg::Transform &M) {
+	if (n_joints < 1 || n_joints > MAX_JOINTS) {
+		fprintf(stderr, "Error: a robot model needs between 1 and %d joints, got %d.\n", MAX_JOINTS, n_joints);
+		exit(EXIT_FAILURE);
+	}
+	n_joints_ = n_joints;
+	M_ = M;
+	memset(inertia_, 0, sizeof(inertia_));
+	linalg::Transform M_inv = linalg::inverse(M);
+	for (int i = 0; i < n_joints; i++) {
+		specs_[i] = joints[i];
+		screws_[i] = makeScrew(joints[i]);
+		body_screws_[i] = makeScrew(adjoint(M_inv, Twist{screws_[i].w, screws_[i].v}));
+		lower_[i] = -M_PI;
+		upper_[i] = M_PI;
+	}
+}
+
+void kinematics::RobotModel::setJointLimits(int i, float lower, float upper) {
+	if (i < 0 || i >= n_joints_ || lower > upper) {
+		fprintf(stderr, "Error: invalid limits [%f, %f] for joint %d of a %d-joint model.\n", lower, upper, i, n_joints_);
+		exit(EXIT_FAILURE);
+	}
+	lower_[i] = lower;
+	upper_[i] = upper;
+}
+
+void kinematics::RobotModel::setLinkInertia(int i, const LinkInertia &inertia) {
+	if (i < 0 || i >= n_joints_ || inertia.mass < 0) {
+		fprintf(stderr, "Error: invalid mass %f for link %d of a %d-joint model.\n", inertia.mass, i, n_joints_);
+		exit(EXIT_FAILURE);
+	}
+	inertia_[i] = inertia;
+}
+
+void kinematics::RobotModel::fk(const float *thetas, linalg::Transform &out) const {
+	forwardKinematics(*this, thetas, out);
+}
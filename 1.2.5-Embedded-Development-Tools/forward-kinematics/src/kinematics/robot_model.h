@@ -0,0 +1,68 @@
+#ifndef __KINEMATICS_ROBOT_MODEL__
+#define __KINEMATICS_ROBOT_MODEL__
+
+#include "screw.h"
+
+namespace kinematics {
+	// Upper bound on the chain length, keeps RobotModel fixed-size and trivially copyable
+	const int MAX_JOINTS = 64;
+
+	class CachedRobotModel;
+
+	// Mass properties of the link moved by a joint, for the dynamics. Lengths are the
+	// model's (mm), so inertias are in kg mm^2. All zero for a massless link.
+	typedef struct LinkInertia {
+		float mass;            // kg
+		linalg::Vec3 com;      // centre of mass at the home configuration, space frame
+		linalg::Mat3 inertia;  // rotational inertia about the centre of mass, space-frame axes at home
+	} LinkInertia;
+
+	// Precomputed product-of-exponentials model of a serial arm.
+	// Everything that only depends on the arm geometry (space and body screw axes,
+	// [w], [w]^2, home transform M) is computed once in the constructor, so fk()
+	// only does the theta-dependent work.
+	class alignas(64) RobotModel {
+	public:
+		RobotModel();
+		RobotModel(const JointSpec *joints, int n_joints, const linalg::Transform &M);
+
+		// out = e^([S1] theta1) * ... * e^([Sn] thetan) * M
+		void fk(const float *thetas, linalg::Transform &out) const;
+
+		int nJoints() const { return n_joints_; }
+		// Space-frame screw axis S_i
+		const Screw &screw(int i) const { return screws_[i]; }
+		// Body-frame screw axis B_i = [Ad_M^-1] S_i
+		const Screw &bodyScrew(int i) const { return body_screws_[i]; }
+		const JointSpec &jointSpec(int i) const { return specs_[i]; }
+		const linalg::Transform &home() const { return M_; }
+
+		// Joint limits in radians, [-pi, pi] unless set
+		void setJointLimits(int i, float lower, float upper);
+		float jointLower(int i) const { return lower_[i]; }
+		float jointUpper(int i) const { return upper_[i]; }
+
+		// Inertia of the link moved by joint i, massless unless set
+		void setLinkInertia(int i, const LinkInertia &inertia);
+		const LinkInertia &linkInertia(int i) const { return inertia_[i]; }
+
+	private:
+		// The binary cache stores the first n_joints_ entries of each array as they are
+		friend class CachedRobotModel;
+		friend bool writeModelCache(const RobotModel &model, const char *cache_path, const char *description_path);
+
+		// Hot data first: screws are 96 bytes, so two joints share exactly three cache lines
+		alignas(64) Screw screws_[MAX_JOINTS];
+		alignas(64) Screw body_screws_[MAX_JOINTS];
+		linalg::Transform M_;
+		int n_joints_;
+		// Cold data, kept for deriving other representations of the same arm
+		JointSpec specs_[MAX_JOINTS];
+		float lower_[MAX_JOINTS];
+		float upper_[MAX_JOINTS];
+		LinkInertia inertia_[MAX_JOINTS];
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_ROBOT_MODEL__*/
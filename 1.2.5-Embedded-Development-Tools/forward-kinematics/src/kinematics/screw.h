@@ -0,0 +1,135 @@
+#ifndef __KINEMATICS_SCREW__
+#define __KINEMATICS_SCREW__
+
+#include <cmath>
+#include "linalg/transform.h"
+
+namespace kinematics {
+	// Geometry of a revolute joint: unit rotation axis omega through a point on the axis
+	template <typename T>
+	struct JointSpecT {
+		linalg::Vec3T<T> omega;
+		linalg::Vec3T<T> point;
+	};
+	typedef JointSpecT<float> JointSpec;
+
+	// Screw axis S = (omega, v) of a revolute joint together with the
+	// theta-independent matrices used by its exponential
+	template <typename T>
+	struct ScrewT {
+		linalg::Mat3T<T> W;  // [omega]
+		linalg::Mat3T<T> W2; // [omega]^2
+		linalg::Vec3T<T> w;  // omega
+		linalg::Vec3T<T> v;  // -omega x point
+	};
+	typedef ScrewT<float> Screw;
+
+	// Twist / screw axis coordinates (omega, v)
+	template <typename T>
+	struct TwistT {
+		linalg::Vec3T<T> w;
+		linalg::Vec3T<T> v;
+	};
+	typedef TwistT<float> Twist;
+
+	template <typename T>
+	inline ScrewT<T> makeScrew(const TwistT<T> &twist) {
+		ScrewT<T> S;
+		S.w = twist.w;
+		S.v = twist.v;
+		S.W = linalg::skew(twist.w);
+		// [w]^2 = w w^T - (w . w) I, cheaper than multiplying [w] by itself
+		const linalg::Vec3T<T> &w = twist.w;
+		T ww = linalg::dot(w, w);
+		S.W2 = linalg::Mat3T<T>{{w.x * w.x - ww, w.x * w.y, w.x * w.z,
+					 w.y * w.x, w.y * w.y - ww, w.y * w.z,
+					 w.z * w.x, w.z * w.y, w.z * w.z - ww}};
+		return S;
+	}
+
+	template <typename T>
+	inline ScrewT<T> makeScrew(const JointSpecT<T> &joint) {
+		return makeScrew(TwistT<T>{joint.omega, -linalg::cross(joint.omega, joint.point)});
+	}
+
+	// [Ad_T] V = (R w, p x (R w) + R v)
+	template <typename T>
+	inline TwistT<T> adjoint(const linalg::TransformT<T> &X, const TwistT<T> &V) {
+		linalg::Vec3T<T> Rw = linalg::mat3MulVec(X.R, V.w);
+		return TwistT<T>{Rw, linalg::cross(X.p, Rw) + linalg::mat3MulVec(X.R, V.v)};
+	}
+
+	// e^([S] theta) for a unit-omega screw:
+	//   R = I + sin(theta) [w] + (1 - cos(theta)) [w]^2
+	//   p = (I theta + (1 - cos(theta)) [w] + (theta - sin(theta)) [w]^2) v
+	template <typename T>
+	inline void expScrew(const ScrewT<T> &S, const T &theta, linalg::TransformT<T> &out) {
+		using std::sin;
+		using std::cos;
+		T s = sin(theta);
+		T a = T(1) - cos(theta);
+		T b = theta - s;
+		linalg::Mat3T<T> G;
+		for (int k = 0; k < 9; k++) {
+			out.R.m[k] = S.W.m[k] * s + S.W2.m[k] * a;
+			G.m[k] = S.W.m[k] * a + S.W2.m[k] * b;
+		}
+		for (int k = 0; k < 9; k += 4) {
+			out.R.m[k] = out.R.m[k] + T(1);
+			G.m[k] = G.m[k] + theta;
+		}
+		out.p = linalg::mat3MulVec(G, S.v);
+	}
+
+	// Coefficients sin(t) / t, (1 - cos(t)) / t^2 and (t - sin(t)) / t^3 of the exponential
+	// of a twist turning by t, with their series near 0 where the quotients lose precision
+	inline void twistCoefficients(float t, float &A, float &B, float &C) {
+		if (t < 1e-2f) {
+			float t2 = t * t;
+			A = 1.0f - t2 * (1.0f / 6.0f);
+			B = 0.5f - t2 * (1.0f / 24.0f);
+			C = 1.0f / 6.0f - t2 * (1.0f / 120.0f);
+		} else {
+			float s = std::sin(t), inv = 1.0f / t;
+			A = s * inv;
+			B = (1.0f - std::cos(t)) * inv * inv;
+			C = (t - s) * inv * inv * inv;
+		}
+	}
+
+	// e^([V]) of a twist of any magnitude, pure translations (w = 0) included:
+	//   R = I + A [w] + B [w]^2,  p = (I + B [w] + C [w]^2) v
+	inline linalg::Transform expTwist(const Twist &V) {
+		float A, B, C;
+		twistCoefficients(linalg::norm(V.w), A, B, C);
+		linalg::Mat3 W = linalg::skew(V.w);
+		linalg::Mat3 W2 = linalg::mat3Mul(W, W);
+		linalg::Transform T;
+		linalg::Mat3 G;
+		for (int k = 0; k < 9; k++) {
+			T.R.m[k] = A * W.m[k] + B * W2.m[k];
+			G.m[k] = B * W.m[k] + C * W2.m[k];
+		}
+		for (int k = 0; k < 9; k += 4) {
+			T.R.m[k] += 1.0f;
+			G.m[k] += 1.0f;
+		}
+		T.p = linalg::mat3MulVec(G, V.v);
+		return T;
+	}
+
+	// Twist V with e^([V]) = T and rotation angle |w| in [0, pi]:
+	//   v = p - [w] p / 2 + (1 - (t / 2) cot(t / 2)) / t^2 [w]^2 p,  t = |w|
+	inline Twist logTransform(const linalg::Transform &T) {
+		linalg::Vec3 w = linalg::logSO3(T.R);
+		float t = linalg::norm(w);
+		// (1 - (t / 2) cot(t / 2)) / t^2 goes to 1 / 12 at 0
+		float D = t < 1e-2f ? 1.0f / 12.0f + t * t * (1.0f / 720.0f) :
+				      (1.0f - 0.5f * t * std::cos(0.5f * t) / std::sin(0.5f * t)) / (t * t);
+		linalg::Vec3 wp = linalg::cross(w, T.p);
+		return Twist{w, T.p - wp * 0.5f + linalg::cross(w, wp) * D};
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_SCREW__*/
@@ -0,0 +1,52 @@
+#ifndef __KINEMATICS_SERVO__
+#define __KINEMATICS_SERVO__
+
+#include <stdint.h>
+#include <cmath>
+
+namespace kinematics {
+	// Servo period of the PCA9685 at 50 Hz, us, and its PWM resolution
+	const int SERVO_PERIOD_US = 20000;
+	const int PCA9685_STEPS = 4096;
+
+	// Mapping of a joint angle onto the servo's 0-180 degree range
+	typedef struct ServoCalibration {
+		// Servo angle at theta = 0, degrees
+		float zero_deg = 90.0f;
+		// -1 if the servo turns against the joint axis
+		float direction = 1.0f;
+		// Range the driver accepts
+		int min_deg = 10;
+		int max_deg = 170;
+	} ServoCalibration;
+
+	// Whole servo degrees for joint angle theta, rounded and clamped like the driver's uint8_t Angle
+	inline int servoDegrees(float theta, const ServoCalibration &cal) {
+		int deg = (int)lrintf(cal.zero_deg + cal.direction * theta * (float)(180.0 / M_PI));
+		return deg < cal.min_deg ? cal.min_deg : (deg > cal.max_deg ? cal.max_deg : deg);
+	}
+
+	// Pulse width in us exactly as PCA9685_Set_Rotation_Angle computes it:
+	// Angle * (2000 / 180) + 500, where the integer division makes it 11 us per degree
+	inline uint16_t servoPulseUs(int deg) {
+		return (uint16_t)(deg * (2000 / 180) + 500);
+	}
+
+	// PWM off count as PCA9685_setServoPulse writes it
+	inline uint16_t pca9685Ticks(uint16_t pulse_us) {
+		return (uint16_t)((uint32_t)pulse_us * PCA9685_STEPS / SERVO_PERIOD_US);
+	}
+
+	// Pulse widths for n row-major configurations of n_joints joints, one calibration per joint,
+	// e.g. straight from Trajectory::sampleUniform
+	inline void servoPulses(const float *thetas, long n, int n_joints, const ServoCalibration *cal, uint16_t *pulses_us) {
+		for (long k = 0; k < n; k++) {
+			for (int j = 0; j < n_joints; j++) {
+				pulses_us[k * n_joints + j] = servoPulseUs(servoDegrees(thetas[k * n_joints + j], cal[j]));
+			}
+		}
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_SERVO__*/
@@ -0,0 +1,119 @@
+#ifndef __KINEMATICS_SPATIAL__
+#define __KINEMATICS_SPATIAL__
+
+#include "screw.h"
+
+namespace kinematics {
+	// Fixed-size 6-vector: a twist (w, v) or a wrench (m, f), angular part first
+	typedef struct Vec6 {
+		float v[6];
+	} Vec6;
+
+	// Fixed-size 6x6 matrix stored in row-major order
+	typedef struct Mat6 {
+		float m[36];
+	} Mat6;
+
+	inline Vec6 toVec6(const Twist &V) {
+		return Vec6{{V.w.x, V.w.y, V.w.z, V.v.x, V.v.y, V.v.z}};
+	}
+
+	inline Vec6 operator+(const Vec6 &a, const Vec6 &b) {
+		Vec6 c;
+		for (int i = 0; i < 6; i++) {
+			c.v[i] = a.v[i] + b.v[i];
+		}
+		return c;
+	}
+
+	inline Vec6 operator*(const Vec6 &a, float s) {
+		Vec6 c;
+		for (int i = 0; i < 6; i++) {
+			c.v[i] = a.v[i] * s;
+		}
+		return c;
+	}
+
+	inline float dot(const Vec6 &a, const Vec6 &b) {
+		float d = 0.0f;
+		for (int i = 0; i < 6; i++) {
+			d += a.v[i] * b.v[i];
+		}
+		return d;
+	}
+
+	inline Vec6 mat6MulVec(const Mat6 &A, const Vec6 &x) {
+		Vec6 y;
+		for (int i = 0; i < 6; i++) {
+			float s = 0.0f;
+			for (int j = 0; j < 6; j++) {
+				s += A.m[i * 6 + j] * x.v[j];
+			}
+			y.v[i] = s;
+		}
+		return y;
+	}
+
+	// A^T x, e.g. to move a wrench with the transpose of a twist adjoint
+	inline Vec6 mat6TransposeMulVec(const Mat6 &A, const Vec6 &x) {
+		Vec6 y = {{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}};
+		for (int j = 0; j < 6; j++) {
+			for (int i = 0; i < 6; i++) {
+				y.v[i] += A.m[j * 6 + i] * x.v[j];
+			}
+		}
+		return y;
+	}
+
+	// [Ad_T] = [R 0; [p] R  R], so that [Ad_T] V == adjoint(T, V)
+	inline Mat6 adjointMatrix(const linalg::Transform &T) {
+		Mat6 A;
+		linalg::Mat3 pR = linalg::mat3Mul(linalg::skew(T.p), T.R);
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				float r = T.R.m[i * 3 + j];
+				A.m[i * 6 + j] = r;
+				A.m[i * 6 + 3 + j] = 0.0f;
+				A.m[(3 + i) * 6 + j] = pR.m[i * 3 + j];
+				A.m[(3 + i) * 6 + 3 + j] = r;
+			}
+		}
+		return A;
+	}
+
+	// [ad_V] X = ([w] wx, [v] wx + [w] vx), the Lie bracket of twists V and X
+	inline Vec6 adTwist(const Vec6 &V, const Vec6 &X) {
+		linalg::Vec3 w{V.v[0], V.v[1], V.v[2]}, v{V.v[3], V.v[4], V.v[5]};
+		linalg::Vec3 xw{X.v[0], X.v[1], X.v[2]}, xv{X.v[3], X.v[4], X.v[5]};
+		linalg::Vec3 a = linalg::cross(w, xw);
+		linalg::Vec3 b = linalg::cross(v, xw) + linalg::cross(w, xv);
+		return Vec6{{a.x, a.y, a.z, b.x, b.y, b.z}};
+	}
+
+	// [ad_V]^T F = (-[w] m - [v] f, -[w] f) for a wrench F = (m, f)
+	inline Vec6 adTransposeWrench(const Vec6 &V, const Vec6 &F) {
+		linalg::Vec3 w{V.v[0], V.v[1], V.v[2]}, v{V.v[3], V.v[4], V.v[5]};
+		linalg::Vec3 m{F.v[0], F.v[1], F.v[2]}, f{F.v[3], F.v[4], F.v[5]};
+		linalg::Vec3 a = -(linalg::cross(w, m) + linalg::cross(v, f));
+		linalg::Vec3 b = -linalg::cross(w, f);
+		return Vec6{{a.x, a.y, a.z, b.x, b.y, b.z}};
+	}
+
+	// G = [I 0; 0 m 1] of a body in a frame at its centre of mass
+	inline Mat6 spatialInertia(const linalg::Mat3 &I, float mass) {
+		Mat6 G;
+		for (int k = 0; k < 36; k++) {
+			G.m[k] = 0.0f;
+		}
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				G.m[i * 6 + j] = I.m[i * 3 + j];
+			}
+			G.m[(3 + i) * 6 + 3 + i] = mass;
+		}
+		return G;
+	}
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_SPATIAL__*/
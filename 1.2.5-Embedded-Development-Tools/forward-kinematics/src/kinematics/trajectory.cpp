@@ -0,0 +1,239 @@
+#include "trajectory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+
+// Samples evaluated per pass of the lane loops, sized to keep the scratch arrays in L1
+static const int SAMPLE_CHUNK = 256;
+
+// Peak |s'| and |s''| of the polynomial profiles over a unit-duration motion:
+// cubic 3u^2 - 2u^3 peaks at 1.5 and 6, quintic 10u^3 - 15u^4 + 6u^5 at 1.875 and 10 / sqrt(3)
+static const float CUBIC_PEAK_V = 1.5f, CUBIC_PEAK_A = 6.0f;
+static const float QUINTIC_PEAK_V = 1.875f, QUINTIC_PEAK_A = 5.7735027f;
+
+/*===================Time scaling s(tau) of one segment===================*/
+
+// Written with selects only so that the loops over samples vectorize
+template <kinematics::TrajectoryProfile P>
+static inline void timeScaling(float tau, float T, float v, float a, float ramp, float &s, float &sd, float &sdd) {
+	tau = tau < 0.0f ? 0.0f : (tau > T ? T : tau);
+	if (P == kinematics::PROFILE_TRAPEZOID) {
+		float r = T - tau;
+		float s_acc = 0.5f * a * tau * tau;
+		float s_cruise = 0.5f * a * ramp * ramp + v * (tau - ramp);
+		float s_dec = 1.0f - 0.5f * a * r * r;
+		bool accelerating = tau < ramp, decelerating = r < ramp;
+		s = accelerating ? s_acc : (decelerating ? s_dec : s_cruise);
+		sd = accelerating ? a * tau : (decelerating ? a * r : v);
+		sdd = accelerating ? a : (decelerating ? -a : 0.0f);
+		// Zero-length segments have nothing to ramp through
+		s = T > 0.0f ? s : 1.0f;
+	} else {
+		float inv_T = T > 0.0f ? 1.0f / T : 0.0f;
+		float u = T > 0.0f ? tau * inv_T : 1.0f;
+		float w = 1.0f - u;
+		if (P == kinematics::PROFILE_CUBIC) {
+			s = u * u * (3.0f - 2.0f * u);
+			sd = 6.0f * u * w * inv_T;
+			sdd = (6.0f - 12.0f * u) * inv_T * inv_T;
+		} else {
+			s = u * u * u * (10.0f + u * (6.0f * u - 15.0f));
+			sd = 30.0f * u * u * w * w * inv_T;
+			sdd = 60.0f * u * w * (1.0f - 2.0f * u) * inv_T * inv_T;
+		}
+	}
+}
+
+/*===================Trajectory===================*/
+
+kinematics::Trajectory::Trajectory() : profile_(PROFILE_CUBIC), n_joints_(0), duration_(0) {}
+
+kinematics::Trajectory::Trajectory(const RobotModel &model, const float *waypoints, int n_waypoints, TrajectoryProfile profile,
+				   const float *max_velocity, const float *max_acceleration)
+	: profile_(profile), n_joints_(model.nJoints()), duration_(0) {
+	const int n = n_joints_;
+	if (n_waypoints < 2) {
+		fprintf(stderr, "Error: a trajectory needs at least 2 waypoints, got %d.\n", n_waypoints);
+		exit(EXIT_FAILURE);
+	}
+	for (int j = 0; j < n; j++) {
+		if (!(max_velocity[j] > 0) || !(max_acceleration[j] > 0)) {
+			fprintf(stderr, "Error: joint %d needs positive velocity and acceleration limits, got %f and %f.\n",
+				j, max_velocity[j], max_acceleration[j]);
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (int i = 0; i < n_waypoints; i++) {
+		for (int j = 0; j < n; j++) {
+			float q = waypoints[i * n + j];
+			if (q < model.jointLower(j) || q > model.jointUpper(j)) {
+				fprintf(stderr, "Error: waypoint %d puts joint %d at %f, outside [%f, %f].\n",
+					i, j, q, model.jointLower(j), model.jointUpper(j));
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+	waypoints_.assign(waypoints, waypoints + n_waypoints * n);
+	deltas_.resize((n_waypoints - 1) * n);
+	segments_.resize(n_waypoints - 1);
+
+	for (int i = 0; i + 1 < n_waypoints; i++) {
+		// Joint j moves by d_j s(t), so the slowest-allowed joint bounds s' and s''
+		float v = INFINITY, a = INFINITY;
+		for (int j = 0; j < n; j++) {
+			float d = waypoints[(i + 1) * n + j] - waypoints[i * n + j];
+			deltas_[i * n + j] = d;
+			if (d != 0.0f) {
+				v = fminf(v, max_velocity[j] / fabsf(d));
+				a = fminf(a, max_acceleration[j] / fabsf(d));
+			}
+		}
+		Segment &seg = segments_[i];
+		seg.t0 = duration_;
+		float T = 0.0f;
+		if (std::isinf(v)) {
+			// The arm is already at the next waypoint
+			seg.v = seg.a = seg.ramp = 0.0f;
+		} else if (profile == PROFILE_TRAPEZOID) {
+			// Cruise if the ramps up to v and back cover less than the whole path,
+			// otherwise a triangle peaking at sqrt(a)
+			if (v * v > a) {
+				v = sqrtf(a);
+			}
+			seg.v = v;
+			seg.a = a;
+			seg.ramp = v / a;
+			T = 1.0f / v + seg.ramp;
+		} else {
+			float peak_v = profile == PROFILE_CUBIC ? CUBIC_PEAK_V : QUINTIC_PEAK_V;
+			float peak_a = profile == PROFILE_CUBIC ? CUBIC_PEAK_A : QUINTIC_PEAK_A;
+			T = fmaxf(peak_v / v, sqrtf(peak_a / a));
+			seg.v = peak_v / T;
+			seg.a = peak_a / (T * T);
+			seg.ramp = 0.0f;
+		}
+		duration_ += T;
+		seg.t1 = duration_;
+	}
+}
+
+long kinematics::Trajectory::samplesAtPeriod(float dt) const {
+	return (long)ceilf(duration_ / dt) + 1;
+}
+
+void kinematics::Trajectory::sample(float t, float *q, float *qd, float *qdd) const {
+	// Last segment ending after t
+	int lo = 0, hi = nSegments() - 1;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (segments_[mid].t1 <= t) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	const Segment &seg = segments_[lo];
+	float s, sd, sdd;
+	float tau = t - seg.t0, T = seg.t1 - seg.t0;
+	switch (profile_) {
+	case PROFILE_CUBIC:
+		timeScaling<PROFILE_CUBIC>(tau, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+		break;
+	case PROFILE_QUINTIC:
+		timeScaling<PROFILE_QUINTIC>(tau, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+		break;
+	default:
+		timeScaling<PROFILE_TRAPEZOID>(tau, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+		break;
+	}
+	const float *q0 = &waypoints_[lo * n_joints_];
+	const float *d = &deltas_[lo * n_joints_];
+	for (int j = 0; j < n_joints_; j++) {
+		q[j] = q0[j] + d[j] * s;
+		if (qd != nullptr) {
+			qd[j] = d[j] * sd;
+		}
+		if (qdd != nullptr) {
+			qdd[j] = d[j] * sdd;
+		}
+	}
+}
+
+// s, s' and s'' of samples t0 + k dt, k in [k0, k1), all inside one segment
+template <kinematics::TrajectoryProfile P>
+static void scaleSamples(float t0, float dt, long k0, long k1, float seg_t0, float T, float v, float a, float ramp,
+			 float *s, float *sd, float *sdd) {
+	const int m = (int)(k1 - k0);
+	#pragma omp simd
+	for (int k = 0; k < m; k++) {
+		timeScaling<P>(t0 + (k0 + k) * dt - seg_t0, T, v, a, ramp, s[k], sd[k], sdd[k]);
+	}
+}
+
+void kinematics::Trajectory::sampleUniform(float t0, float dt, long n, float *q, float *qd, float *qdd) const {
+	if (!(dt > 0)) {
+		fprintf(stderr, "Error: trajectory sample period must be positive, got %f.\n", dt);
+		exit(EXIT_FAILURE);
+	}
+	const int n_j = n_joints_;
+	const int last = nSegments() - 1;
+	alignas(64) float s[SAMPLE_CHUNK], sd[SAMPLE_CHUNK], sdd[SAMPLE_CHUNK];
+	int i = 0;
+	long k0 = 0;
+	while (k0 < n) {
+		// Sample times only increase, so the segment index only moves forward
+		while (i < last && t0 + k0 * dt >= segments_[i].t1) {
+			i++;
+		}
+		const Segment &seg = segments_[i];
+		long k_max = k0 + SAMPLE_CHUNK < n ? k0 + SAMPLE_CHUNK : n;
+		long k1 = k0 + 1;
+		while (k1 < k_max && (i == last || t0 + k1 * dt < seg.t1)) {
+			k1++;
+		}
+		float T = seg.t1 - seg.t0;
+		switch (profile_) {
+		case PROFILE_CUBIC:
+			scaleSamples<PROFILE_CUBIC>(t0, dt, k0, k1, seg.t0, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+			break;
+		case PROFILE_QUINTIC:
+			scaleSamples<PROFILE_QUINTIC>(t0, dt, k0, k1, seg.t0, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+			break;
+		default:
+			scaleSamples<PROFILE_TRAPEZOID>(t0, dt, k0, k1, seg.t0, T, seg.v, seg.a, seg.ramp, s, sd, sdd);
+			break;
+		}
+		const float *w = &waypoints_[i * n_j];
+		const float *d = &deltas_[i * n_j];
+		const int m = (int)(k1 - k0);
+		float *q_out = q + k0 * n_j;
+		for (int j = 0; j < n_j; j++) {
+			const float wj = w[j], dj = d[j];
+			#pragma omp simd
+			for (int k = 0; k < m; k++) {
+				q_out[k * n_j + j] = wj + dj * s[k];
+			}
+		}
+		if (qd != nullptr) {
+			float *qd_out = qd + k0 * n_j;
+			for (int j = 0; j < n_j; j++) {
+				const float dj = d[j];
+				#pragma omp simd
+				for (int k = 0; k < m; k++) {
+					qd_out[k * n_j + j] = dj * sd[k];
+				}
+			}
+		}
+		if (qdd != nullptr) {
+			float *qdd_out = qdd + k0 * n_j;
+			for (int j = 0; j < n_j; j++) {
+				const float dj = d[j];
+				#pragma omp simd
+				for (int k = 0; k < m; k++) {
+					qdd_out[k * n_j + j] = dj * sdd[k];
+				}
+			}
+		}
+		k0 = k1;
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef __KINEMATICS_TRAJECTORY__
+#define __KINEMATICS_TRAJECTORY__
+
+#include <vector>
+#include "robot_model.h"
+
+namespace kinematics {
+	typedef enum TrajectoryProfile {
+		// Third-order polynomial, zero velocity at both ends
+		PROFILE_CUBIC,
+		// Fifth-order polynomial, zero velocity and acceleration at both ends
+		PROFILE_QUINTIC,
+		// Constant acceleration, cruise at the velocity limit, constant deceleration
+		PROFILE_TRAPEZOID
+	} TrajectoryProfile;
+
+	// Straight-line motion in joint space through a list of waypoints, stopping at each one.
+	// All joints of a segment follow the same time scaling s(t) from 0 to 1, so they start
+	// and arrive together; the segment takes the shortest time that keeps every joint
+	// within its velocity and acceleration limits.
+	class Trajectory {
+	public:
+		Trajectory();
+		// waypoints is n_waypoints x nJoints, row-major, within the model's joint limits.
+		// Limits are per joint, rad/s and rad/s^2.
+		Trajectory(const RobotModel &model, const float *waypoints, int n_waypoints, TrajectoryProfile profile,
+			   const float *max_velocity, const float *max_acceleration);
+
+		int nJoints() const { return n_joints_; }
+		int nSegments() const { return (int)segments_.size(); }
+		TrajectoryProfile profile() const { return profile_; }
+		// Total time, s
+		float duration() const { return duration_; }
+		// Time at which the arm reaches waypoint i
+		float waypointTime(int i) const { return i == 0 ? 0.0f : segments_[i - 1].t1; }
+
+		// Joint positions (and optionally velocities and accelerations) at time t,
+		// holding the first or last waypoint outside [0, duration()]
+		void sample(float t, float *q, float *qd = nullptr, float *qdd = nullptr) const;
+		// n samples at t0, t0 + dt, ..., written row-major (n x nJoints) so they can go straight
+		// to fkBatch, CollisionModel::checkTrajectory, InverseDynamics::torquesBatch or servoPulses
+		void sampleUniform(float t0, float dt, long n, float *q, float *qd = nullptr, float *qdd = nullptr) const;
+		// Samples needed to cover the whole trajectory at period dt, both ends included
+		long samplesAtPeriod(float dt) const;
+
+	private:
+		typedef struct Segment {
+			float t0, t1;
+			// Path velocity and acceleration limits of s(t), and the trapezoid's ramp time
+			float v, a, ramp;
+		} Segment;
+
+		TrajectoryProfile profile_;
+		int n_joints_;
+		float duration_;
+		// n_waypoints x n_joints, then the per-segment displacements
+		std::vector<float> waypoints_;
+		std::vector<float> deltas_;
+		std::vector<Segment> segments_;
+	};
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_TRAJECTORY__*/
@@ -0,0 +1,262 @@
+#include "workspace.h"
+#include "fk_simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <omp.h>
+
+static const char MAP_MAGIC[8] = {'F', 'K', 'W', 'S', 'M', 'A', 'P', '\0'};
+static const uint32_t MAP_VERSION = 1;
+
+typedef struct alignas(64) MapHeader {
+	char magic[8];
+	uint32_t version;
+	int32_t nx, ny, nz;
+	float origin[3];
+	float voxel_size;
+	int32_t orientation_resolution;
+	int32_t approach_axis;
+	int64_t samples;
+	int64_t outside;
+} MapHeader;
+
+static void checkSpec(const kinematics::WorkspaceGridSpec &spec) {
+	if (spec.nx < 1 || spec.ny < 1 || spec.nz < 1 || !(spec.voxel_size > 0) ||
+	    spec.orientation_resolution < 1 || spec.orientation_resolution > kinematics::MAX_ORIENTATION_RESOLUTION ||
+	    spec.approach_axis < 0 || spec.approach_axis > 2) {
+		fprintf(stderr, "Error: invalid workspace grid %d x %d x %d, voxel %f mm, orientation resolution %d, approach axis %d.\n",
+			spec.nx, spec.ny, spec.nz, spec.voxel_size, spec.orientation_resolution, spec.approach_axis);
+		exit(EXIT_FAILURE);
+	}
+}
+
+kinematics::WorkspaceMap::WorkspaceMap() : spec_(), samples_(0), outside_(0) {}
+
+kinematics::WorkspaceMap::WorkspaceMap(const WorkspaceGridSpec &spec) : spec_(spec), samples_(0), outside_(0) {
+	checkSpec(spec);
+	long n = (long)spec.nx * spec.ny * spec.nz;
+	hits_.assign(n, 0);
+	orientations_.assign(n, 0);
+}
+
+int kinematics::WorkspaceMap::orientationBins() const {
+	return 6 * spec_.orientation_resolution * spec_.orientation_resolution;
+}
+
+long kinematics::WorkspaceMap::voxelIndex(const linalg::Vec3 &p) const {
+	float inv = 1.0f / spec_.voxel_size;
+	float fx = (p.x - spec_.origin.x) * inv;
+	float fy = (p.y - spec_.origin.y) * inv;
+	float fz = (p.z - spec_.origin.z) * inv;
+	if (!(fx >= 0 && fy >= 0 && fz >= 0 && fx < spec_.nx && fy < spec_.ny && fz < spec_.nz)) {
+		return -1;
+	}
+	return ((long)fz * spec_.ny + (long)fy) * spec_.nx + (long)fx;
+}
+
+long kinematics::WorkspaceMap::reachableVoxels() const {
+	long count = 0;
+	for (uint32_t h : hits_) {
+		count += h > 0;
+	}
+	return count;
+}
+
+bool kinematics::WorkspaceMap::write(const char *path) const {
+	FILE *f = fopen(path, "wb");
+	if (f == nullptr) {
+		return false;
+	}
+	MapHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+	header.version = MAP_VERSION;
+	header.nx = spec_.nx;
+	header.ny = spec_.ny;
+	header.nz = spec_.nz;
+	header.origin[0] = spec_.origin.x;
+	header.origin[1] = spec_.origin.y;
+	header.origin[2] = spec_.origin.z;
+	header.voxel_size = spec_.voxel_size;
+	header.orientation_resolution = spec_.orientation_resolution;
+	header.approach_axis = spec_.approach_axis;
+	header.samples = samples_;
+	header.outside = outside_;
+	size_t n = hits_.size();
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+		  fwrite(hits_.data(), sizeof(uint32_t), n, f) == n &&
+		  fwrite(orientations_.data(), sizeof(uint64_t), n, f) == n;
+	return fclose(f) == 0 && ok;
+}
+
+bool kinematics::WorkspaceMap::read(const char *path) {
+	FILE *f = fopen(path, "rb");
+	if (f == nullptr) {
+		return false;
+	}
+	MapHeader header;
+	bool ok = fread(&header, sizeof(header), 1, f) == 1 && memcmp(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) == 0 &&
+		  header.version == MAP_VERSION && header.nx > 0 && header.ny > 0 && header.nz > 0 &&
+		  header.orientation_resolution >= 1 && header.orientation_resolution <= MAX_ORIENTATION_RESOLUTION &&
+		  header.approach_axis >= 0 && header.approach_axis <= 2 && header.voxel_size > 0;
+	if (ok) {
+		spec_ = WorkspaceGridSpec{{header.origin[0], header.origin[1], header.origin[2]}, header.voxel_size,
+					  header.nx, header.ny, header.nz, header.orientation_resolution, header.approach_axis};
+		size_t n = (size_t)header.nx * header.ny * header.nz;
+		hits_.assign(n, 0);
+		orientations_.assign(n, 0);
+		samples_ = header.samples;
+		outside_ = header.outside;
+		ok = fread(hits_.data(), sizeof(uint32_t), n, f) == n && fread(orientations_.data(), sizeof(uint64_t), n, f) == n;
+	}
+	fclose(f);
+	return ok;
+}
+
+int kinematics::orientationBin(const linalg::Vec3 &d, int resolution) {
+	const float c[3] = {d.x, d.y, d.z};
+	const float a[3] = {fabsf(d.x), fabsf(d.y), fabsf(d.z)};
+	// Dominant axis picks the cube face, the other two coordinates the cell on it
+	int axis = (a[0] >= a[1] && a[0] >= a[2]) ? 0 : (a[1] >= a[2] ? 1 : 2);
+	int face = 2 * axis + (c[axis] < 0);
+	float inv = a[axis] > 0 ? 1.0f / a[axis] : 0.0f;
+	float u = c[(axis + 1) % 3] * inv;
+	float v = c[(axis + 2) % 3] * inv;
+	int iu = (int)((u + 1.0f) * 0.5f * resolution);
+	int iv = (int)((v + 1.0f) * 0.5f * resolution);
+	iu = iu < 0 ? 0 : (iu >= resolution ? resolution - 1 : iu);
+	iv = iv < 0 ? 0 : (iv >= resolution ? resolution - 1 : iv);
+	return (face * resolution + iu) * resolution + iv;
+}
+
+kinematics::WorkspaceGridSpec kinematics::workspaceBounds(const RobotModel &model, float voxel_size, int orientation_resolution) {
+	// Every joint rotates the rest of the chain about its axis, which cannot move the
+	// tool farther from the first joint point than the chain's total length
+	linalg::Vec3 base = model.jointSpec(0).point;
+	float reach = 0;
+	for (int i = 1; i < model.nJoints(); i++) {
+		reach += linalg::norm(model.jointSpec(i).point - model.jointSpec(i - 1).point);
+	}
+	reach += linalg::norm(model.home().p - model.jointSpec(model.nJoints() - 1).point);
+	// One voxel of margin on each side
+	int n = (int)ceilf(2.0f * reach / voxel_size) + 2;
+	float half = 0.5f * n * voxel_size;
+	return WorkspaceGridSpec{base - linalg::Vec3{half, half, half}, voxel_size, n, n, n, orientation_resolution, 2};
+}
+
+// splitmix64 of the sample index and joint, so a sample does not depend on which thread draws it
+static inline float uniform01(uint64_t seed, uint64_t sample, int joint) {
+	uint64_t z = seed + (sample * kinematics::MAX_JOINTS + joint + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+	return (float)(z >> 40) * (1.0f / (float)(1ULL << 24));
+}
+
+long kinematics::samplingCount(const RobotModel &model, const WorkspaceSamplingOptions &options) {
+	if (options.mode == SAMPLE_UNIFORM) {
+		if (options.samples < 1) {
+			fprintf(stderr, "Error: uniform sampling needs at least one sample, got %ld.\n", options.samples);
+			exit(EXIT_FAILURE);
+		}
+		return options.samples;
+	}
+	if (options.grid_points < 2) {
+		fprintf(stderr, "Error: a joint-space grid needs at least 2 points per joint, got %d.\n", options.grid_points);
+		exit(EXIT_FAILURE);
+	}
+	long total = 1;
+	for (int j = 0; j < model.nJoints(); j++) {
+		if (total > (1L << 40) / options.grid_points) {
+			fprintf(stderr, "Error: a %d-point grid over %d joints is too many samples.\n", options.grid_points, model.nJoints());
+			exit(EXIT_FAILURE);
+		}
+		total *= options.grid_points;
+	}
+	return total;
+}
+
+void kinematics::sampleConfiguration(const RobotModel &model, const WorkspaceSamplingOptions &options, long sample, float *thetas) {
+	long rest = sample;
+	for (int j = 0; j < model.nJoints(); j++) {
+		float lo = model.jointLower(j), hi = model.jointUpper(j);
+		float u;
+		if (options.mode == SAMPLE_GRID) {
+			u = (float)(rest % options.grid_points) / (options.grid_points - 1);
+			rest /= options.grid_points;
+		} else {
+			u = uniform01(options.seed, sample, j);
+		}
+		thetas[j] = lo + (hi - lo) * u;
+	}
+}
+
+void kinematics::sampleWorkspace(const RobotModel &model, const WorkspaceSamplingOptions &options, WorkspaceMap &map) {
+	const int n_joints = model.nJoints();
+	const long total = samplingCount(model, options);
+	const long n_voxels = map.nVoxels();
+	const long n_blocks = (total + FK_LANES - 1) / FK_LANES;
+	const int max_threads = omp_get_max_threads();
+	std::vector<std::vector<uint32_t>> thread_hits(max_threads);
+	std::vector<std::vector<uint64_t>> thread_orientations(max_threads);
+	long outside = 0;
+
+	#pragma omp parallel reduction(+ : outside)
+	{
+		const int t = omp_get_thread_num();
+		const int n_threads = omp_get_num_threads();
+		// Private model and grid, allocated and first touched by this thread
+		RobotModel local = model;
+		std::vector<uint32_t> &hits = thread_hits[t];
+		std::vector<uint64_t> &orientations = thread_orientations[t];
+		hits.assign(n_voxels, 0);
+		orientations.assign(n_voxels, 0);
+		alignas(32) float thetas[MAX_JOINTS * FK_LANES];
+		TransformBatch batch;
+		const WorkspaceGridSpec &spec = map.spec();
+
+		#pragma omp for schedule(static)
+		for (long block = 0; block < n_blocks; block++) {
+			for (int lane = 0; lane < FK_LANES; lane++) {
+				// Lanes past the end repeat the last sample and are not counted
+				long sample = block * FK_LANES + lane;
+				float q[MAX_JOINTS];
+				sampleConfiguration(local, options, sample < total ? sample : total - 1, q);
+				for (int j = 0; j < n_joints; j++) {
+					thetas[j * FK_LANES + lane] = q[j];
+				}
+			}
+			fkLanes(local, thetas, batch);
+			int lanes = total - block * FK_LANES < FK_LANES ? (int)(total - block * FK_LANES) : FK_LANES;
+			for (int lane = 0; lane < lanes; lane++) {
+				linalg::Vec3 p{batch.p[0][lane], batch.p[1][lane], batch.p[2][lane]};
+				long voxel = map.voxelIndex(p);
+				if (voxel < 0) {
+					outside++;
+					continue;
+				}
+				const int a = spec.approach_axis;
+				linalg::Vec3 approach{batch.R[a][lane], batch.R[3 + a][lane], batch.R[6 + a][lane]};
+				hits[voxel]++;
+				orientations[voxel] |= 1ULL << orientationBin(approach, spec.orientation_resolution);
+			}
+		}
+
+		// Merge: each thread owns a slice of voxels and folds every private grid into it
+		#pragma omp barrier
+		#pragma omp for schedule(static)
+		for (long v = 0; v < n_voxels; v++) {
+			uint32_t h = map.hits_[v];
+			uint64_t o = map.orientations_[v];
+			for (int k = 0; k < n_threads; k++) {
+				h += thread_hits[k][v];
+				o |= thread_orientations[k][v];
+			}
+			map.hits_[v] = h;
+			map.orientations_[v] = o;
+		}
+	}
+	map.samples_ += total;
+	map.outside_ += outside;
+}
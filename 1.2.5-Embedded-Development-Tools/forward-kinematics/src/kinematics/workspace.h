@@ -0,0 +1,96 @@
+#ifndef __KINEMATICS_WORKSPACE__
+#define __KINEMATICS_WORKSPACE__
+
+#include <stdint.h>
+#include <vector>
+#include "robot_model.h"
+
+namespace kinematics {
+	// Orientation bins are the cells of a cube map over the approach direction:
+	// 6 faces of resolution x resolution cells, so 3 gives 54 bins in a 64-bit mask
+	const int MAX_ORIENTATION_RESOLUTION = 3;
+
+	typedef struct WorkspaceGridSpec {
+		// Corner of voxel (0, 0, 0) and edge length, mm
+		linalg::Vec3 origin;
+		float voxel_size;
+		int nx, ny, nz;
+		int orientation_resolution;
+		// Column of the end-effector rotation taken as the approach direction
+		int approach_axis;
+	} WorkspaceGridSpec;
+
+	typedef enum WorkspaceSampling {
+		// Independent uniform draws within the joint limits, reproducible from the seed
+		SAMPLE_UNIFORM,
+		// grid_points evenly spaced values per joint, limits included
+		SAMPLE_GRID
+	} WorkspaceSampling;
+
+	typedef struct WorkspaceSamplingOptions {
+		WorkspaceSampling mode = SAMPLE_UNIFORM;
+		long samples = 1 << 20;
+		int grid_points = 32;
+		uint64_t seed = 1;
+	} WorkspaceSamplingOptions;
+
+	// Voxel occupancy grid with per-voxel orientation coverage: hits counts the samples
+	// that ended in the voxel, the orientation mask has a bit per approach-direction bin reached
+	class WorkspaceMap {
+	public:
+		WorkspaceMap();
+		explicit WorkspaceMap(const WorkspaceGridSpec &spec);
+
+		const WorkspaceGridSpec &spec() const { return spec_; }
+		long nVoxels() const { return (long)hits_.size(); }
+		int orientationBins() const;
+		// Voxel holding p, -1 outside the grid
+		long voxelIndex(const linalg::Vec3 &p) const;
+
+		uint32_t hits(long voxel) const { return hits_[voxel]; }
+		uint64_t orientations(long voxel) const { return orientations_[voxel]; }
+		int orientationCoverage(long voxel) const { return __builtin_popcountll(orientations_[voxel]); }
+		// Fraction of the orientation bins reached in the voxel
+		float reachability(long voxel) const { return (float)orientationCoverage(voxel) / orientationBins(); }
+		long reachableVoxels() const;
+
+		long samples() const { return samples_; }
+		// Samples that landed outside the grid
+		long outside() const { return outside_; }
+
+		// Binary file: a 64-byte header (magic "FKWSMAP", version, grid spec, sample counts),
+		// then nVoxels() uint32 hit counts and nVoxels() uint64 orientation masks, x fastest
+		bool write(const char *path) const;
+		// Replaces this map with the file's contents; false if it is missing or malformed
+		bool read(const char *path);
+
+	private:
+		friend void sampleWorkspace(const RobotModel &model, const WorkspaceSamplingOptions &options, WorkspaceMap &map);
+
+		WorkspaceGridSpec spec_;
+		std::vector<uint32_t> hits_;
+		std::vector<uint64_t> orientations_;
+		long samples_;
+		long outside_;
+	};
+
+	// Number of configurations the sampling options describe for model; exits if a grid is too large
+	long samplingCount(const RobotModel &model, const WorkspaceSamplingOptions &options);
+	// Joint angles of configuration `sample` in [0, samplingCount()), independent of the caller's thread
+	void sampleConfiguration(const RobotModel &model, const WorkspaceSamplingOptions &options, long sample, float *thetas);
+
+	// Bin of a unit direction in the cube map of the given resolution
+	int orientationBin(const linalg::Vec3 &direction, int resolution);
+
+	// Grid centred on the base that is guaranteed to contain the reachable workspace:
+	// its half-width is the sum of the distances along the chain of joint points to the tool
+	WorkspaceGridSpec workspaceBounds(const RobotModel &model, float voxel_size, int orientation_resolution = MAX_ORIENTATION_RESOLUTION);
+
+	// Samples joint space across OpenMP threads with fkLanes() and adds the end-effector
+	// positions to map. Every thread fills a private grid that is merged at the end, so
+	// threads never share a counter; the result does not depend on the thread count.
+	void sampleWorkspace(const RobotModel &model, const WorkspaceSamplingOptions &options, WorkspaceMap &map);
+
+} /*namespace kinematics*/
+
+#endif /*__KINEMATICS_WORKSPACE__*/
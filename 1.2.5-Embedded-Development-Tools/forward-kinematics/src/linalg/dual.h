@@ -0,0 +1,128 @@
+#ifndef __LINALG_DUAL__
+#define __LINALG_DUAL__
+
+#include <cmath>
+
+namespace linalg {
+	// Forward-mode dual number carrying N partial derivatives alongside the value.
+	// Drop-in scalar for the templated Vec3T/Mat3T/TransformT code: evaluating a
+	// function once on Dual<N> inputs yields its value and N directional derivatives.
+	template <int N>
+	struct Dual {
+		float v;
+		float d[N];
+
+		Dual() {}
+		Dual(float value) : v(value) {
+			for (int k = 0; k < N; k++) {
+				d[k] = 0;
+			}
+		}
+
+		// Independent variable number k: d/dx_k x = 1
+		static Dual variable(float value, int k) {
+			Dual x(value);
+			x.d[k] = 1;
+			return x;
+		}
+	};
+
+	/*===================Arithmetic===================*/
+
+	template <int N>
+	inline Dual<N> operator+(const Dual<N> &a, const Dual<N> &b) {
+		Dual<N> c;
+		c.v = a.v + b.v;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = a.d[k] + b.d[k];
+		}
+		return c;
+	}
+
+	template <int N>
+	inline Dual<N> operator-(const Dual<N> &a, const Dual<N> &b) {
+		Dual<N> c;
+		c.v = a.v - b.v;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = a.d[k] - b.d[k];
+		}
+		return c;
+	}
+
+	template <int N>
+	inline Dual<N> operator-(const Dual<N> &a) {
+		Dual<N> c;
+		c.v = -a.v;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = -a.d[k];
+		}
+		return c;
+	}
+
+	template <int N>
+	inline Dual<N> operator*(const Dual<N> &a, const Dual<N> &b) {
+		Dual<N> c;
+		c.v = a.v * b.v;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = a.d[k] * b.v + a.v * b.d[k];
+		}
+		return c;
+	}
+
+	template <int N>
+	inline Dual<N> operator/(const Dual<N> &a, const Dual<N> &b) {
+		Dual<N> c;
+		float inv = 1.0f / b.v;
+		c.v = a.v * inv;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = (a.d[k] - c.v * b.d[k]) * inv;
+		}
+		return c;
+	}
+
+	// Mixed Dual/float arithmetic goes through the implicit float constructor
+	template <int N> inline Dual<N> operator+(const Dual<N> &a, float b) { return a + Dual<N>(b); }
+	template <int N> inline Dual<N> operator+(float a, const Dual<N> &b) { return Dual<N>(a) + b; }
+	template <int N> inline Dual<N> operator-(const Dual<N> &a, float b) { return a - Dual<N>(b); }
+	template <int N> inline Dual<N> operator-(float a, const Dual<N> &b) { return Dual<N>(a) - b; }
+	template <int N> inline Dual<N> operator*(const Dual<N> &a, float b) { return a * Dual<N>(b); }
+	template <int N> inline Dual<N> operator*(float a, const Dual<N> &b) { return Dual<N>(a) * b; }
+	template <int N> inline Dual<N> operator/(const Dual<N> &a, float b) { return a / Dual<N>(b); }
+	template <int N> inline Dual<N> operator/(float a, const Dual<N> &b) { return Dual<N>(a) / b; }
+
+	// Comparisons only look at the value
+	template <int N> inline bool operator<(const Dual<N> &a, const Dual<N> &b) { return a.v < b.v; }
+	template <int N> inline bool operator>(const Dual<N> &a, const Dual<N> &b) { return a.v > b.v; }
+
+	/*===================Elementary functions===================*/
+
+	// Chain rule: f(a).d = f'(a.v) * a.d
+	template <int N>
+	inline Dual<N> chain(const Dual<N> &a, float f, float df) {
+		Dual<N> c;
+		c.v = f;
+		for (int k = 0; k < N; k++) {
+			c.d[k] = df * a.d[k];
+		}
+		return c;
+	}
+
+	template <int N>
+	inline Dual<N> sin(const Dual<N> &a) {
+		return chain(a, std::sin(a.v), std::cos(a.v));
+	}
+
+	template <int N>
+	inline Dual<N> cos(const Dual<N> &a) {
+		return chain(a, std::cos(a.v), -std::sin(a.v));
+	}
+
+	template <int N>
+	inline Dual<N> sqrt(const Dual<N> &a) {
+		float s = std::sqrt(a.v);
+		return chain(a, s, s > 0 ? 0.5f / s : 0.0f);
+	}
+
+} /*namespace linalg*/
+
+#endif /*__LINALG_DUAL__*/
@@ -77,7 +77,7 @@ void linalg::printMat(Matrix &mat, std::string name) {
 void linalg::matCopy(Matrix &dst, Matrix &src) {
 	if (isMatAllocated(dst) && isMatAllocated(src)) {
 		// Dimension check
-		if ((dst.n_rows != dst.n_rows) || (src.n_cols != dst.n_cols)) {
+		if ((src.n_rows != dst.n_rows) || (src.n_cols != dst.n_cols)) {
 			fprintf(stderr, "Error: Dimension mismatch. A matrix of size (%d, %d) cannot be assigned to a matrix of size (%d, %d).\n", 
 					src.n_rows, src.n_cols, dst.n_rows, dst.n_cols);
 			exit(EXIT_FAILURE);
@@ -199,10 +199,13 @@ void linalg::crossProduct(Matrix &matA, Matrix &matB, Matrix &matC) {
 			fprintf(stderr, "Error: cannot perform cross product between mathematical objects that are not 3D vectors.\n");
 			exit(EXIT_FAILURE);
 		}
-		for (int i = 0; i < 4; i++) {
-			*(matC.p + i - 1) = *(matA.p + (i%3)) * *(matB.p + (i+1)%3) - 
-								*(matB.p + (i%3)) * *(matA.p + (i+1)%3);
-		}
+		// Compute into temporaries first so matC may alias matA or matB
+		float x = matA.p[1] * matB.p[2] - matA.p[2] * matB.p[1];
+		float y = matA.p[2] * matB.p[0] - matA.p[0] * matB.p[2];
+		float z = matA.p[0] * matB.p[1] - matA.p[1] * matB.p[0];
+		matC.p[0] = x;
+		matC.p[1] = y;
+		matC.p[2] = z;
 	}
 }
 
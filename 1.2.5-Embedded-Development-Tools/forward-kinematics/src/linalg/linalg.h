@@ -3,6 +3,7 @@
 
 #include <string>
 #include <stdarg.h>
+#include "vec3.h"
 
 namespace linalg {
 	// Matrix
@@ -0,0 +1,130 @@
+#ifndef __LINALG_TRANSFORM__
+#define __LINALG_TRANSFORM__
+
+#include "vec3.h"
+
+namespace linalg {
+	// Rigid body transform in SE(3): rotation R and translation p.
+	// Equivalent to the homogeneous matrix [R p; 0 1] without the constant last row.
+	template <typename T>
+	struct TransformT {
+		Mat3T<T> R;
+		Vec3T<T> p;
+	};
+	typedef TransformT<float> Transform;
+
+	/*===================3x3 matrix arithmetic===================*/
+
+	template <typename T>
+	inline Mat3T<T> mat3Identity() {
+		return Mat3T<T>{{T(1), T(0), T(0),
+				 T(0), T(1), T(0),
+				 T(0), T(0), T(1)}};
+	}
+
+	template <typename T>
+	inline Mat3T<T> mat3Mul(const Mat3T<T> &a, const Mat3T<T> &b) {
+		Mat3T<T> c;
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				c.m[i * 3 + j] = a.m[i * 3] * b.m[j] + a.m[i * 3 + 1] * b.m[3 + j] + a.m[i * 3 + 2] * b.m[6 + j];
+			}
+		}
+		return c;
+	}
+
+	template <typename T>
+	inline Vec3T<T> mat3MulVec(const Mat3T<T> &a, const Vec3T<T> &v) {
+		return Vec3T<T>{a.m[0] * v.x + a.m[1] * v.y + a.m[2] * v.z,
+				a.m[3] * v.x + a.m[4] * v.y + a.m[5] * v.z,
+				a.m[6] * v.x + a.m[7] * v.y + a.m[8] * v.z};
+	}
+
+	template <typename T>
+	inline Mat3T<T> mat3Transpose(const Mat3T<T> &a) {
+		return Mat3T<T>{{a.m[0], a.m[3], a.m[6],
+				 a.m[1], a.m[4], a.m[7],
+				 a.m[2], a.m[5], a.m[8]}};
+	}
+
+	/*===================Transform arithmetic===================*/
+
+	template <typename T>
+	inline TransformT<T> transformIdentity() {
+		return TransformT<T>{mat3Identity<T>(), Vec3T<T>{T(0), T(0), T(0)}};
+	}
+
+	// a * b
+	template <typename T>
+	inline TransformT<T> compose(const TransformT<T> &a, const TransformT<T> &b) {
+		return TransformT<T>{mat3Mul(a.R, b.R), mat3MulVec(a.R, b.p) + a.p};
+	}
+
+	// [R p]^-1 = [R^T -R^T p]
+	template <typename T>
+	inline TransformT<T> inverse(const TransformT<T> &a) {
+		Mat3T<T> Rt = mat3Transpose(a.R);
+		return TransformT<T>{Rt, -mat3MulVec(Rt, a.p)};
+	}
+
+	template <typename T>
+	inline Vec3T<T> transformPoint(const TransformT<T> &a, const Vec3T<T> &x) {
+		return mat3MulVec(a.R, x) + a.p;
+	}
+
+	// Matrix logarithm of a rotation as the rotation vector w * theta, theta in [0, pi]
+	inline Vec3 logSO3(const Mat3 &R) {
+		// vee(R - R^T) = 2 sin(theta) w and trace(R) = 1 + 2 cos(theta); atan2 keeps
+		// theta accurate near 0 and pi, where acos of the trace alone loses digits
+		Vec3 axis{R.m[7] - R.m[5], R.m[2] - R.m[6], R.m[3] - R.m[1]};
+		float sin_theta = 0.5f * norm(axis);
+		float theta = std::atan2(sin_theta, 0.5f * (R.m[0] + R.m[4] + R.m[8] - 1.0f));
+		if (theta < 1e-3f) {
+			// sin(theta) ~ theta
+			return axis * 0.5f;
+		}
+		if (theta > 3.0f) {
+			// Near pi the antisymmetric part vanishes, recover w from the symmetric part
+			// (R + R^T) / 2 - cos(theta) I = (1 - cos(theta)) w w^T, using its largest
+			// diagonal entry for stability
+			float c = std::cos(theta);
+			float d[3] = {R.m[0] - c, R.m[4] - c, R.m[8] - c};
+			int k = (d[0] >= d[1] && d[0] >= d[2]) ? 0 : (d[1] >= d[2] ? 1 : 2);
+			float col[3] = {0.5f * (R.m[k] + R.m[3 * k]), 0.5f * (R.m[3 + k] + R.m[3 * k + 1]), 0.5f * (R.m[6 + k] + R.m[3 * k + 2])};
+			col[k] = d[k];
+			Vec3 w = normalize(Vec3{col[0], col[1], col[2]});
+			// Keep the sign consistent with the (small) antisymmetric part
+			if (dot(w, axis) < 0) {
+				w = -w;
+			}
+			return w * theta;
+		}
+		return axis * (0.5f * theta / sin_theta);
+	}
+
+	// Row-major 4x4 homogeneous matrix, e.g. to fill a linalg::Matrix
+	inline void toHomogeneous(const Transform &a, float *out) {
+		for (int i = 0; i < 3; i++) {
+			out[i * 4 + 0] = a.R.m[i * 3 + 0];
+			out[i * 4 + 1] = a.R.m[i * 3 + 1];
+			out[i * 4 + 2] = a.R.m[i * 3 + 2];
+		}
+		out[3] = a.p.x;
+		out[7] = a.p.y;
+		out[11] = a.p.z;
+		out[12] = 0;
+		out[13] = 0;
+		out[14] = 0;
+		out[15] = 1;
+	}
+
+	inline Transform fromHomogeneous(const float *vals) {
+		return Transform{{{vals[0], vals[1], vals[2],
+				   vals[4], vals[5], vals[6],
+				   vals[8], vals[9], vals[10]}},
+				 {vals[3], vals[7], vals[11]}};
+	}
+
+} /*namespace linalg*/
+
+#endif /*__LINALG_TRANSFORM__*/
@@ -0,0 +1,38 @@
+#include "vec3.h"
+
+/*===================Batched vector arithmetic===================*/
+
+void linalg::crossBatch(const Vec3 *a, const Vec3 *b, Vec3 *out, int n) {
+	#pragma omp simd
+	for (int i = 0; i < n; i++) {
+		out[i] = cross(a[i], b[i]);
+	}
+}
+
+void linalg::dotBatch(const Vec3 *a, const Vec3 *b, float *out, int n) {
+	#pragma omp simd
+	for (int i = 0; i < n; i++) {
+		out[i] = dot(a[i], b[i]);
+	}
+}
+
+void linalg::normBatch(const Vec3 *a, float *out, int n) {
+	#pragma omp simd
+	for (int i = 0; i < n; i++) {
+		out[i] = norm(a[i]);
+	}
+}
+
+void linalg::normalizeBatch(const Vec3 *a, Vec3 *out, int n) {
+	#pragma omp simd
+	for (int i = 0; i < n; i++) {
+		out[i] = normalize(a[i]);
+	}
+}
+
+void linalg::skewBatch(const Vec3 *a, Mat3 *out, int n) {
+	#pragma omp simd
+	for (int i = 0; i < n; i++) {
+		out[i] = skew(a[i]);
+	}
+}
@@ -0,0 +1,94 @@
+#ifndef __LINALG_VEC3__
+#define __LINALG_VEC3__
+
+#include <cmath>
+
+namespace linalg {
+	// Fixed-size 3D vector, passed around by value (no heap allocation)
+	template <typename T>
+	struct Vec3T {
+		T x, y, z;
+	};
+	typedef Vec3T<float> Vec3;
+
+	// Fixed-size 3x3 matrix stored in row-major order
+	template <typename T>
+	struct Mat3T {
+		T m[9];
+	};
+	typedef Mat3T<float> Mat3;
+
+	/*===================Vector arithmetic===================*/
+
+	template <typename T>
+	inline Vec3T<T> operator+(const Vec3T<T> &a, const Vec3T<T> &b) {
+		return Vec3T<T>{a.x + b.x, a.y + b.y, a.z + b.z};
+	}
+
+	template <typename T>
+	inline Vec3T<T> operator-(const Vec3T<T> &a, const Vec3T<T> &b) {
+		return Vec3T<T>{a.x - b.x, a.y - b.y, a.z - b.z};
+	}
+
+	template <typename T>
+	inline Vec3T<T> operator-(const Vec3T<T> &a) {
+		return Vec3T<T>{-a.x, -a.y, -a.z};
+	}
+
+	template <typename T>
+	inline Vec3T<T> operator*(const Vec3T<T> &a, const T &s) {
+		return Vec3T<T>{a.x * s, a.y * s, a.z * s};
+	}
+
+	template <typename T>
+	inline Vec3T<T> operator*(const T &s, const Vec3T<T> &a) {
+		return Vec3T<T>{a.x * s, a.y * s, a.z * s};
+	}
+
+	template <typename T>
+	inline T dot(const Vec3T<T> &a, const Vec3T<T> &b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	template <typename T>
+	inline Vec3T<T> cross(const Vec3T<T> &a, const Vec3T<T> &b) {
+		return Vec3T<T>{a.y * b.z - a.z * b.y,
+				a.z * b.x - a.x * b.z,
+				a.x * b.y - a.y * b.x};
+	}
+
+	template <typename T>
+	inline T norm(const Vec3T<T> &a) {
+		using std::sqrt;
+		return sqrt(dot(a, a));
+	}
+
+	// The zero vector normalizes to zero; the ternary compiles to a select, not a branch
+	template <typename T>
+	inline Vec3T<T> normalize(const Vec3T<T> &a) {
+		using std::sqrt;
+		T n2 = dot(a, a);
+		T inv = (n2 > T(0)) ? T(1) / sqrt(n2) : T(0);
+		return a * inv;
+	}
+
+	// [a] such that [a] * b == cross(a, b)
+	template <typename T>
+	inline Mat3T<T> skew(const Vec3T<T> &a) {
+		return Mat3T<T>{{T(0), -a.z,  a.y,
+				  a.z, T(0), -a.x,
+				 -a.y,  a.x, T(0)}};
+	}
+
+	/*===================Batched vector arithmetic===================*/
+
+	// out[i] = f(a[i], b[i]) for i in [0, n); out may alias a or b
+	void crossBatch(const Vec3 *a, const Vec3 *b, Vec3 *out, int n);
+	void dotBatch(const Vec3 *a, const Vec3 *b, float *out, int n);
+	void normBatch(const Vec3 *a, float *out, int n);
+	void normalizeBatch(const Vec3 *a, Vec3 *out, int n);
+	void skewBatch(const Vec3 *a, Mat3 *out, int n);
+
+} /*namespace linalg*/
+
+#endif /*__LINALG_VEC3__*/
@@ -1,24 +1,18 @@
-#include <string>
 #include <omp.h>
 #include <cmath>
 #include <benchmark/benchmark.h>
 #include "linalg/linalg.h"
+#include "kinematics/arm_specs.h"
+#include "kinematics/arm_loader.h"
+#include "fk_course_arm.h"
 
 #define VECTOR_SIZE 3
 
 void PoE(float *thetas, float *points, float *omegas, linalg::Matrix &result, int N);
 
-typedef struct RoboticArmSpecs {
-	const int N_JOINTS = 4;
-	// In milimeters
-	const float L1 = 31.0f;
-	const float L2 = 80.0f;
-	const float L3 = 80.0f;
-	const float L4 = 62.0f;
-} RoboticArmSpecs;
-
-int main() {
-	RoboticArmSpecs arm;
+// Usage: out [arm_description.txt [model_cache.bin]]
+int main(int argc, char **argv) {
+	kinematics::RoboticArmSpecs arm;
 	// Matrices declaration
 	linalg::Matrix M, T_eb, result;
 	// Matrices allocation
@@ -48,6 +42,30 @@ int main() {
 	PoE(thetas, points, omegas, T_eb, arm.N_JOINTS);
 	linalg::matMul(T_eb, M, result);
 	linalg::printMat(result, "Final result");
+
+	// Same pose through the precomputed model, loaded from an arm description if one is given
+	kinematics::CachedRobotModel loaded;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	const kinematics::RobotModel *active = &model;
+	if (argc > 1) {
+		// Only cache the parsed model where asked to, never next to the description
+		kinematics::loadRobotModel(argv[1], argc > 2 ? argv[2] : nullptr, loaded);
+		active = loaded.get();
+	}
+	linalg::Transform T;
+	active->fk(thetas, T);
+	float T_vals[16];
+	linalg::toHomogeneous(T, T_vals);
+	linalg::populateMatWithValues(result, T_vals, 16);
+	linalg::printMat(result, "RobotModel result");
+
+	// Same pose through the generated fast path, when the active model is the arm it was generated for
+	if (kinematics::generated::fk_course_arm_matches(*active)) {
+		kinematics::generated::fk_course_arm(thetas, T);
+		linalg::toHomogeneous(T, T_vals);
+		linalg::populateMatWithValues(result, T_vals, 16);
+		linalg::printMat(result, "Generated result");
+	}
 }
 
 void PoE(float *thetas, float *points, float *omegas, linalg::Matrix &result, int N) {
@@ -0,0 +1,169 @@
+#include "periodic_executor.h"
+#include "rt_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+static const long NS_PER_S = 1000000000L;
+
+static long nowNs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * NS_PER_S + ts.tv_nsec;
+}
+
+static void sleepUntil(long t_ns) {
+	timespec ts;
+	ts.tv_sec = t_ns / NS_PER_S;
+	ts.tv_nsec = t_ns % NS_PER_S;
+	// Signals interrupt the sleep; with an absolute deadline it can simply be resumed
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+	}
+}
+
+static int latencyBin(long latency_ns) {
+	long us = latency_ns / 1000;
+	int bin = 0;
+	while (us > 0 && bin < runtime::LATENCY_BINS - 1) {
+		us >>= 1;
+		bin++;
+	}
+	return bin;
+}
+
+runtime::PeriodicExecutor::PeriodicExecutor(const ExecutorOptions &options)
+	: options_(options), stop_requested_(false), ran_realtime_(false) {
+	if (options.period_ns <= 0 || options.max_catch_up < 0) {
+		fprintf(stderr, "Error: invalid executor period %ld ns or catch-up limit %d.\n", options.period_ns, options.max_catch_up);
+		exit(EXIT_FAILURE);
+	}
+	memset(&stats_, 0, sizeof(stats_));
+	resetStats();
+}
+
+int runtime::PeriodicExecutor::addStage(const char *name, StageFn fn, void *user) {
+	if (stats_.n_stages >= MAX_STAGES) {
+		fprintf(stderr, "Error: an executor holds at most %d stages, cannot add '%s'.\n", MAX_STAGES, name);
+		exit(EXIT_FAILURE);
+	}
+	int i = stats_.n_stages++;
+	stages_[i] = Stage{fn, user};
+	stats_.stages[i] = StageStats{name, 0, 0, 0};
+	return i;
+}
+
+void runtime::PeriodicExecutor::resetStats() {
+	stats_.ticks = 0;
+	stats_.deadline_misses = 0;
+	stats_.skipped_releases = 0;
+	stats_.latency_min_ns = LONG_MAX;
+	stats_.latency_max_ns = 0;
+	stats_.latency_sum_ns = 0;
+	memset(stats_.latency_histogram, 0, sizeof(stats_.latency_histogram));
+	stats_.tick_max_ns = 0;
+	stats_.fault_ticks = 0;
+	stats_.minor_faults = 0;
+	stats_.major_faults = 0;
+	stats_.first_fault_tick = -1;
+	for (int i = 0; i < stats_.n_stages; i++) {
+		stats_.stages[i].runs = 0;
+		stats_.stages[i].total_ns = 0;
+		stats_.stages[i].max_ns = 0;
+	}
+}
+
+long runtime::PeriodicExecutor::latencyQuantileNs(double p) const {
+	long target = (long)(p * stats_.ticks);
+	long seen = 0;
+	for (int bin = 0; bin < LATENCY_BINS; bin++) {
+		seen += stats_.latency_histogram[bin];
+		if (seen > target || (seen == stats_.ticks && seen > 0)) {
+			return (1L << bin) * 1000;
+		}
+	}
+	return 0;
+}
+
+void runtime::PeriodicExecutor::run(long n_ticks) {
+	stop_requested_ = false;
+	ran_realtime_ = false;
+	int old_policy = SCHED_OTHER;
+	sched_param old_param;
+	pthread_getschedparam(pthread_self(), &old_policy, &old_param);
+	if (options_.realtime) {
+		sched_param param;
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = options_.priority;
+		int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (err != 0) {
+			fprintf(stderr, "Warning: SCHED_FIFO priority %d unavailable (%s), using the default scheduler.\n",
+				options_.priority, strerror(err));
+		}
+		ran_realtime_ = err == 0;
+	}
+
+	const long period = options_.period_ns;
+	long release = nowNs() + period;
+	for (long tick = 0; (n_ticks <= 0 || tick < n_ticks) && !stop_requested_; tick++) {
+		sleepUntil(release);
+		long start = nowNs();
+		long latency = start - release;
+		latency = latency > 0 ? latency : 0;
+		stats_.latency_min_ns = latency < stats_.latency_min_ns ? latency : stats_.latency_min_ns;
+		stats_.latency_max_ns = latency > stats_.latency_max_ns ? latency : stats_.latency_max_ns;
+		stats_.latency_sum_ns += latency;
+		stats_.latency_histogram[latencyBin(latency)]++;
+
+		PageFaultCounts faults_before{0, 0};
+		if (options_.track_page_faults) {
+			faults_before = threadPageFaults();
+		}
+		long t = start;
+		for (int i = 0; i < stats_.n_stages; i++) {
+			stages_[i].fn(stages_[i].user);
+			long t_end = nowNs();
+			StageStats &s = stats_.stages[i];
+			s.runs++;
+			s.total_ns += t_end - t;
+			s.max_ns = t_end - t > s.max_ns ? t_end - t : s.max_ns;
+			t = t_end;
+		}
+		if (options_.track_page_faults && tick >= options_.fault_warmup_ticks) {
+			PageFaultCounts faults_after = threadPageFaults();
+			long minor = faults_after.minor - faults_before.minor;
+			long major = faults_after.major - faults_before.major;
+			if (minor + major > 0) {
+				stats_.first_fault_tick = stats_.fault_ticks == 0 ? tick : stats_.first_fault_tick;
+				stats_.fault_ticks++;
+				stats_.minor_faults += minor;
+				stats_.major_faults += major;
+			}
+		}
+		stats_.tick_max_ns = t - start > stats_.tick_max_ns ? t - start : stats_.tick_max_ns;
+		stats_.ticks++;
+
+		release += period;
+		if (t > release) {
+			stats_.deadline_misses++;
+			// Releases at or before now have already passed
+			long passed = (t - release) / period + 1;
+			if (options_.overrun == OVERRUN_SKIP) {
+				release += passed * period;
+				stats_.skipped_releases += passed;
+			} else if (passed > options_.max_catch_up) {
+				long dropped = passed - options_.max_catch_up;
+				release += dropped * period;
+				stats_.skipped_releases += dropped;
+			}
+		}
+	}
+
+	if (ran_realtime_) {
+		pthread_setschedparam(pthread_self(), old_policy, &old_param);
+	}
+}
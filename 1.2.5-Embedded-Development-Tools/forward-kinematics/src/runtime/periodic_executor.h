@@ -0,0 +1,105 @@
+#ifndef __RUNTIME_PERIODIC_EXECUTOR__
+#define __RUNTIME_PERIODIC_EXECUTOR__
+
+#include <atomic>
+
+namespace runtime {
+	// Work done once per tick, in the order the stages were added
+	typedef void (*StageFn)(void *user);
+
+	// Fixed so that running and recording a tick never allocates
+	const int MAX_STAGES = 8;
+	// Release latency histogram: bin 0 is < 1 us, bin k is [2^(k-1), 2^k) us, the last bin is open-ended
+	const int LATENCY_BINS = 24;
+
+	typedef enum OverrunPolicy {
+		// Drop the releases that passed while a tick overran and resume on the next future one
+		OVERRUN_SKIP,
+		// Run the missed ticks back to back until the schedule is met again
+		// (at most max_catch_up of them, then the rest are skipped)
+		OVERRUN_CATCH_UP
+	} OverrunPolicy;
+
+	typedef struct ExecutorOptions {
+		long period_ns = 1000000;  // 1 kHz
+		OverrunPolicy overrun = OVERRUN_SKIP;
+		int max_catch_up = 10;
+		// Ask for SCHED_FIFO at this priority while running; without the privilege
+		// (a stock desktop) a warning is printed and the default scheduler is kept
+		bool realtime = false;
+		int priority = 80;
+		// Sample getrusage(RUSAGE_THREAD) around every tick and count the page faults
+		// taken by the stages; ticks before fault_warmup_ticks are not counted
+		bool track_page_faults = false;
+		long fault_warmup_ticks = 0;
+	} ExecutorOptions;
+
+	typedef struct StageStats {
+		const char *name;
+		long runs;
+		long total_ns;
+		long max_ns;
+	} StageStats;
+
+	typedef struct ExecutorStats {
+		long ticks;
+		// Ticks that finished after the next release
+		long deadline_misses;
+		// Releases dropped by the overrun policy
+		long skipped_releases;
+		// Release latency: wake-up time minus scheduled release time
+		long latency_min_ns;
+		long latency_max_ns;
+		long latency_sum_ns;
+		long latency_histogram[LATENCY_BINS];
+		// Start of the first stage to the end of the last one
+		long tick_max_ns;
+		// With track_page_faults: steady-state ticks that faulted and the faults they took
+		long fault_ticks;
+		long minor_faults;
+		long major_faults;
+		// First steady-state tick that faulted, -1 if none
+		long first_fault_tick;
+		int n_stages;
+		StageStats stages[MAX_STAGES];
+	} ExecutorStats;
+
+	// Fixed-rate loop on the calling thread, released by clock_nanosleep(TIMER_ABSTIME)
+	// on CLOCK_MONOTONIC so that period errors do not accumulate.
+	class PeriodicExecutor {
+	public:
+		explicit PeriodicExecutor(const ExecutorOptions &options = ExecutorOptions());
+
+		// Returns the stage index; exits if more than MAX_STAGES are added
+		int addStage(const char *name, StageFn fn, void *user);
+
+		// Runs n_ticks ticks, or until stop() when n_ticks <= 0
+		void run(long n_ticks);
+		// Safe from a stage or from another thread; the current tick completes
+		void stop() { stop_requested_ = true; }
+
+		const ExecutorStats &stats() const { return stats_; }
+		void resetStats();
+		double latencyMeanNs() const { return stats_.ticks ? (double)stats_.latency_sum_ns / stats_.ticks : 0.0; }
+		// Upper bound of the histogram bin holding the p-th quantile, p in [0, 1]
+		long latencyQuantileNs(double p) const;
+		// Whether the last run() got SCHED_FIFO
+		bool ranRealtime() const { return ran_realtime_; }
+		const ExecutorOptions &options() const { return options_; }
+
+	private:
+		typedef struct Stage {
+			StageFn fn;
+			void *user;
+		} Stage;
+
+		ExecutorOptions options_;
+		Stage stages_[MAX_STAGES];
+		ExecutorStats stats_;
+		std::atomic<bool> stop_requested_;
+		bool ran_realtime_;
+	};
+
+} /*namespace runtime*/
+
+#endif /*__RUNTIME_PERIODIC_EXECUTOR__*/
@@ -0,0 +1,121 @@
+#include "rt_memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+static size_t pageSize() {
+	long size = sysconf(_SC_PAGESIZE);
+	return size > 0 ? (size_t)size : 4096;
+}
+
+// Separate frame so the touched stack lies below the caller's
+__attribute__((noinline)) static void prefaultStack(size_t bytes) {
+	volatile char *stack = (volatile char *)alloca(bytes);
+	size_t page = pageSize();
+	for (size_t i = 0; i < bytes; i += page) {
+		stack[i] = 0;
+	}
+}
+
+// Parses a cpu list such as "2-3,6" and checks whether it contains cpu
+static bool cpuListContains(const char *list, int cpu) {
+	const char *cursor = list;
+	while (*cursor != '\0' && *cursor != '\n') {
+		char *end;
+		long lo = strtol(cursor, &end, 10);
+		if (end == cursor) {
+			return false;
+		}
+		long hi = lo;
+		if (*end == '-') {
+			cursor = end + 1;
+			hi = strtol(cursor, &end, 10);
+		}
+		if (cpu >= lo && cpu <= hi) {
+			return true;
+		}
+		cursor = *end == ',' ? end + 1 : end;
+	}
+	return false;
+}
+
+static bool cpuIsolated(int cpu) {
+	FILE *f = fopen("/sys/devices/system/cpu/isolated", "r");
+	if (f == nullptr) {
+		return false;
+	}
+	char list[256] = {0};
+	bool isolated = fgets(list, sizeof(list), f) != nullptr && cpuListContains(list, cpu);
+	fclose(f);
+	return isolated;
+}
+
+runtime::RtMemoryStatus runtime::enterRealtimeMemoryMode(const RtMemoryOptions &options) {
+	RtMemoryStatus status{false, false, false};
+
+	// Keep every freed heap page and serve large requests from the heap instead of fresh mmaps
+	mallopt(M_TRIM_THRESHOLD, -1);
+	mallopt(M_MMAP_MAX, 0);
+
+	if (options.lock_memory) {
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+			status.locked = true;
+		} else {
+			fprintf(stderr, "Warning: mlockall failed (%s), memory may be swapped out; raise RLIMIT_MEMLOCK or run with CAP_IPC_LOCK.\n",
+				strerror(errno));
+		}
+	}
+
+	if (options.heap_reserve_bytes > 0) {
+		char *reserve = (char *)malloc(options.heap_reserve_bytes);
+		if (reserve != nullptr) {
+			prefaultBuffer(reserve, options.heap_reserve_bytes);
+			free(reserve);
+		}
+	}
+	if (options.stack_prefault_bytes > 0) {
+		prefaultStack(options.stack_prefault_bytes);
+	}
+
+	if (options.cpu >= 0) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(options.cpu, &set);
+		int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		if (err == 0) {
+			status.pinned = true;
+			status.cpu_isolated = cpuIsolated(options.cpu);
+			if (!status.cpu_isolated) {
+				fprintf(stderr, "Warning: CPU %d is not isolated (isolcpus=), other tasks may still run on it.\n", options.cpu);
+			}
+		} else {
+			fprintf(stderr, "Warning: cannot pin the control thread to CPU %d (%s).\n", options.cpu, strerror(err));
+		}
+	}
+	return status;
+}
+
+void runtime::prefaultBuffer(void *buf, size_t bytes) {
+	volatile char *bytes_ptr = (volatile char *)buf;
+	size_t page = pageSize();
+	for (size_t i = 0; i < bytes; i += page) {
+		bytes_ptr[i] = bytes_ptr[i];
+	}
+	if (bytes > 0) {
+		bytes_ptr[bytes - 1] = bytes_ptr[bytes - 1];
+	}
+}
+
+runtime::PageFaultCounts runtime::threadPageFaults() {
+	rusage usage;
+	getrusage(RUSAGE_THREAD, &usage);
+	return PageFaultCounts{usage.ru_minflt, usage.ru_majflt};
+}
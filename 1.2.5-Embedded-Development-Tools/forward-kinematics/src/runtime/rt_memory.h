@@ -0,0 +1,45 @@
+#ifndef __RUNTIME_RT_MEMORY__
+#define __RUNTIME_RT_MEMORY__
+
+#include <stddef.h>
+
+namespace runtime {
+	typedef struct RtMemoryOptions {
+		// mlockall(MCL_CURRENT | MCL_FUTURE): nothing already mapped or mapped later gets swapped out
+		bool lock_memory = true;
+		// Heap grown, touched and kept (malloc trimming and mmap'ed chunks are disabled),
+		// so allocations made after startup reuse resident pages
+		size_t heap_reserve_bytes = 8 << 20;
+		// Stack depth touched on the calling thread
+		size_t stack_prefault_bytes = 512 << 10;
+		// CPU to pin the calling thread to, -1 to leave the affinity alone
+		int cpu = -1;
+	} RtMemoryOptions;
+
+	typedef struct RtMemoryStatus {
+		bool locked;
+		bool pinned;
+		// The pinned CPU is listed in /sys/devices/system/cpu/isolated (isolcpus=)
+		bool cpu_isolated;
+	} RtMemoryStatus;
+
+	typedef struct PageFaultCounts {
+		long minor;
+		long major;
+	} PageFaultCounts;
+
+	// Startup mode for the control thread: locks memory, prefaults the heap and this
+	// thread's stack and pins the thread. Call it on the control thread before creating
+	// the buffers it will use. Anything that cannot be done without privileges
+	// (mlockall beyond RLIMIT_MEMLOCK, a missing CPU) is reported as a warning and skipped.
+	RtMemoryStatus enterRealtimeMemoryMode(const RtMemoryOptions &options = RtMemoryOptions());
+
+	// Writes one byte per page so the buffer is backed by resident memory before the hot loop
+	void prefaultBuffer(void *buf, size_t bytes);
+
+	// Page faults taken so far by the calling thread, from getrusage(RUSAGE_THREAD)
+	PageFaultCounts threadPageFaults();
+
+} /*namespace runtime*/
+
+#endif /*__RUNTIME_RT_MEMORY__*/
@@ -0,0 +1,371 @@
+// Build-time generator: emits straight-line C++ FK (and optionally the space
+// Jacobian) for one arm description, with every structural zero and one of the
+// screw axes and home pose folded away.
+//
+// Usage: fk_codegen <arm_description.txt> <name> <output_dir> [--jacobian]
+// Writes <output_dir>/fk_<name>.h and <output_dir>/fk_<name>.cpp.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "kinematics/arm_loader.h"
+
+/*===================Symbolic polynomials===================*/
+
+// Sum of coefficient * product-of-symbols terms. Symbols are indices into a name
+// table; a term's key is its sorted symbol list (empty for the constant term).
+typedef std::map<std::vector<int>, double> Expr;
+
+static std::vector<std::string> symbol_names;
+
+// Coefficients this close to zero are treated as structural zeros (float noise in the screws)
+static const double ZERO_EPS = 1e-7;
+
+static int newSymbol(const std::string &name) {
+	symbol_names.push_back(name);
+	return (int)symbol_names.size() - 1;
+}
+
+static Expr constant(double c) {
+	Expr e;
+	if (fabs(c) > ZERO_EPS) {
+		e[std::vector<int>()] = c;
+	}
+	return e;
+}
+
+static Expr symbol(int id) {
+	Expr e;
+	e[std::vector<int>(1, id)] = 1.0;
+	return e;
+}
+
+static void addTerm(Expr &e, const std::vector<int> &key, double c) {
+	double &slot = e[key];
+	slot += c;
+	if (fabs(slot) <= ZERO_EPS) {
+		e.erase(key);
+	}
+}
+
+static Expr add(const Expr &a, const Expr &b) {
+	Expr c = a;
+	for (auto &term : b) {
+		addTerm(c, term.first, term.second);
+	}
+	return c;
+}
+
+static Expr sub(const Expr &a, const Expr &b) {
+	Expr c = a;
+	for (auto &term : b) {
+		addTerm(c, term.first, -term.second);
+	}
+	return c;
+}
+
+static Expr scale(const Expr &a, double s) {
+	Expr c;
+	if (fabs(s) <= ZERO_EPS) {
+		return c;
+	}
+	for (auto &term : a) {
+		addTerm(c, term.first, term.second * s);
+	}
+	return c;
+}
+
+static Expr mul(const Expr &a, const Expr &b) {
+	Expr c;
+	for (auto &ta : a) {
+		for (auto &tb : b) {
+			std::vector<int> key = ta.first;
+			key.insert(key.end(), tb.first.begin(), tb.first.end());
+			std::sort(key.begin(), key.end());
+			addTerm(c, key, ta.second * tb.second);
+		}
+	}
+	return c;
+}
+
+static std::string number(double c) {
+	// Snap values that are integers up to float noise, e.g. 0.99999994 -> 1
+	double r = std::round(c);
+	if (fabs(c - r) < 1e-6) {
+		c = r;
+	}
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%.9g", c);
+	std::string s(buf);
+	if (s.find_first_of(".e") == std::string::npos) {
+		s += ".0";
+	}
+	return s + "f";
+}
+
+static std::string toCode(const Expr &e) {
+	if (e.empty()) {
+		return "0.0f";
+	}
+	std::string code;
+	for (auto &term : e) {
+		double c = term.second;
+		bool negative = c < 0;
+		double mag = fabs(c);
+		std::string product;
+		for (size_t k = 0; k < term.first.size(); k++) {
+			product += (k ? " * " : "") + symbol_names[term.first[k]];
+		}
+		std::string piece;
+		if (product.empty()) {
+			piece = number(mag);
+		} else if (fabs(mag - 1.0) < 1e-6) {
+			piece = product;
+		} else {
+			piece = number(mag) + " * " + product;
+		}
+		if (code.empty()) {
+			code = negative ? "-" + piece : piece;
+		} else {
+			code += negative ? " - " + piece : " + " + piece;
+		}
+	}
+	return code;
+}
+
+// A constant or a single symbol with coefficient +-1 is already as cheap as it gets
+static bool isAtomic(const Expr &e) {
+	if (e.empty()) {
+		return true;
+	}
+	if (e.size() != 1) {
+		return false;
+	}
+	auto &term = *e.begin();
+	return term.first.empty() || (term.first.size() == 1 && fabs(fabs(term.second) - 1.0) < 1e-6);
+}
+
+// Emits a temporary for a non-trivial expression and returns it as a symbol,
+// which keeps later products small
+static Expr materialize(FILE *f, const Expr &e, const std::string &name) {
+	if (isAtomic(e)) {
+		return e;
+	}
+	fprintf(f, "\tconst float %s = %s;\n", name.c_str(), toCode(e).c_str());
+	return symbol(newSymbol(name));
+}
+
+/*===================Symbolic transforms===================*/
+
+typedef struct SymTransform {
+	Expr R[9];
+	Expr p[3];
+} SymTransform;
+
+static SymTransform compose(const SymTransform &a, const SymTransform &b) {
+	SymTransform c;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			c.R[i * 3 + j] = add(add(mul(a.R[i * 3], b.R[j]), mul(a.R[i * 3 + 1], b.R[3 + j])), mul(a.R[i * 3 + 2], b.R[6 + j]));
+		}
+		c.p[i] = add(add(add(mul(a.R[i * 3], b.p[0]), mul(a.R[i * 3 + 1], b.p[1])), mul(a.R[i * 3 + 2], b.p[2])), a.p[i]);
+	}
+	return c;
+}
+
+static SymTransform constantTransform(const linalg::Transform &T) {
+	SymTransform c;
+	for (int k = 0; k < 9; k++) {
+		c.R[k] = constant(T.R.m[k]);
+	}
+	c.p[0] = constant(T.p.x);
+	c.p[1] = constant(T.p.y);
+	c.p[2] = constant(T.p.z);
+	return c;
+}
+
+// e^([S] theta) with the same formulas as expScrew(), written in s = sin(theta), c = cos(theta)
+// and t = theta so that 1 - a and t - b cancel symbolically (for a revolute screw every t term drops out)
+static SymTransform expScrew(const kinematics::Screw &S, int s, int c, int t) {
+	SymTransform E;
+	Expr a = sub(constant(1.0), symbol(c));
+	Expr b = sub(symbol(t), symbol(s));
+	Expr G[9];
+	for (int k = 0; k < 9; k++) {
+		double diag = (k % 4 == 0) ? 1.0 : 0.0;
+		E.R[k] = add(add(constant(diag), scale(symbol(s), S.W.m[k])), scale(a, S.W2.m[k]));
+		G[k] = add(add(scale(symbol(t), diag), scale(a, S.W.m[k])), scale(b, S.W2.m[k]));
+	}
+	const float v[3] = {S.v.x, S.v.y, S.v.z};
+	for (int r = 0; r < 3; r++) {
+		E.p[r] = add(add(scale(G[r * 3], v[0]), scale(G[r * 3 + 1], v[1])), scale(G[r * 3 + 2], v[2]));
+	}
+	return E;
+}
+
+static SymTransform materialize(FILE *f, const SymTransform &T, const std::string &prefix) {
+	SymTransform out;
+	for (int k = 0; k < 9; k++) {
+		out.R[k] = materialize(f, T.R[k], prefix + "R" + std::to_string(k));
+	}
+	for (int k = 0; k < 3; k++) {
+		out.p[k] = materialize(f, T.p[k], prefix + "p" + std::to_string(k));
+	}
+	return out;
+}
+
+/*===================Code emission===================*/
+
+// True if the identifier appears in code as a whole token
+static bool usesSymbol(const std::string &code, const std::string &name) {
+	for (size_t at = code.find(name); at != std::string::npos; at = code.find(name, at + 1)) {
+		bool start = at == 0 || !(isalnum((unsigned char)code[at - 1]) || code[at - 1] == '_');
+		size_t end = at + name.size();
+		bool stop = end == code.size() || !(isalnum((unsigned char)code[end]) || code[end] == '_');
+		if (start && stop) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Emits the body shared by FK and FK + Jacobian. The chain is generated first so that
+// only the sines, cosines and angles it actually references get declared.
+static void emitChain(FILE *out, const kinematics::RobotModel &model, bool jacobian) {
+	symbol_names.clear();
+	char *buffer = nullptr;
+	size_t buffer_size = 0;
+	FILE *f = open_memstream(&buffer, &buffer_size);
+	const int n = model.nJoints();
+	SymTransform P;
+	for (int i = 0; i < n; i++) {
+		std::string idx = std::to_string(i);
+		const kinematics::Screw &S = model.screw(i);
+		if (jacobian) {
+			// J[i] = [Ad_P] S_i = (R w, p x (R w) + R v), with P the product before joint i
+			Expr w[3], v[3];
+			const float sw[3] = {S.w.x, S.w.y, S.w.z};
+			const float sv[3] = {S.v.x, S.v.y, S.v.z};
+			for (int r = 0; r < 3; r++) {
+				w[r] = constant(0);
+				v[r] = constant(0);
+				for (int c = 0; c < 3; c++) {
+					Expr Rrc = (i == 0) ? constant(r == c ? 1.0 : 0.0) : P.R[r * 3 + c];
+					w[r] = add(w[r], scale(Rrc, sw[c]));
+					v[r] = add(v[r], scale(Rrc, sv[c]));
+				}
+			}
+			if (i > 0) {
+				v[0] = add(v[0], sub(mul(P.p[1], w[2]), mul(P.p[2], w[1])));
+				v[1] = add(v[1], sub(mul(P.p[2], w[0]), mul(P.p[0], w[2])));
+				v[2] = add(v[2], sub(mul(P.p[0], w[1]), mul(P.p[1], w[0])));
+			}
+			const char *axis = "xyz";
+			for (int r = 0; r < 3; r++) {
+				fprintf(f, "\tJ[%d].w.%c = %s;\n", i, axis[r], toCode(w[r]).c_str());
+			}
+			for (int r = 0; r < 3; r++) {
+				fprintf(f, "\tJ[%d].v.%c = %s;\n", i, axis[r], toCode(v[r]).c_str());
+			}
+		}
+		fprintf(f, "\t// Joint %d\n", i);
+		int s = newSymbol("s" + idx), c = newSymbol("c" + idx), t = newSymbol("t" + idx);
+		SymTransform E = expScrew(S, s, c, t);
+		P = (i == 0) ? materialize(f, E, "e0_") : materialize(f, compose(P, E), "P" + idx + "_");
+	}
+	SymTransform T = compose(P, constantTransform(model.home()));
+	for (int k = 0; k < 9; k++) {
+		fprintf(f, "\tout.R.m[%d] = %s;\n", k, toCode(T.R[k]).c_str());
+	}
+	fprintf(f, "\tout.p.x = %s;\n", toCode(T.p[0]).c_str());
+	fprintf(f, "\tout.p.y = %s;\n", toCode(T.p[1]).c_str());
+	fprintf(f, "\tout.p.z = %s;\n", toCode(T.p[2]).c_str());
+	fclose(f);
+
+	std::string body(buffer, buffer_size);
+	free(buffer);
+	for (int i = 0; i < n; i++) {
+		std::string idx = std::to_string(i);
+		if (usesSymbol(body, "t" + idx)) {
+			fprintf(out, "\tconst float t%d = thetas[%d];\n", i, i);
+		}
+		if (usesSymbol(body, "s" + idx)) {
+			fprintf(out, "\tconst float s%d = sinf(thetas[%d]);\n", i, i);
+		}
+		if (usesSymbol(body, "c" + idx)) {
+			fprintf(out, "\tconst float c%d = cosf(thetas[%d]);\n", i, i);
+		}
+	}
+	fputs(body.c_str(), out);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 4) {
+		fprintf(stderr, "Usage: %s <arm_description.txt> <name> <output_dir> [--jacobian]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	const char *description = argv[1];
+	std::string name = argv[2];
+	std::string out_dir = argv[3];
+	bool jacobian = argc > 4 && strcmp(argv[4], "--jacobian") == 0;
+	kinematics::RobotModel model = kinematics::parseArmDescription(description);
+
+	std::string header_path = out_dir + "/fk_" + name + ".h";
+	std::string source_path = out_dir + "/fk_" + name + ".cpp";
+	FILE *h = fopen(header_path.c_str(), "w");
+	FILE *f = fopen(source_path.c_str(), "w");
+	if (h == nullptr || f == nullptr) {
+		fprintf(stderr, "Error: cannot write generated files to %s.\n", out_dir.c_str());
+		return EXIT_FAILURE;
+	}
+
+	std::string guard = "__FK_GENERATED_" + name + "__";
+	fprintf(h, "// Generated by fk_codegen from %s. Do not edit.\n", description);
+	fprintf(h, "#ifndef %s\n#define %s\n\n", guard.c_str(), guard.c_str());
+	fprintf(h, "#include \"kinematics/robot_model.h\"\n\n");
+	fprintf(h, "namespace kinematics {\nnamespace generated {\n");
+	fprintf(h, "\tconst int fk_%s_joints = %d;\n", name.c_str(), model.nJoints());
+	fprintf(h, "\t// Same result as forwardKinematics() on the described arm\n");
+	fprintf(h, "\tvoid fk_%s(const float *thetas, linalg::Transform &out);\n", name.c_str());
+	if (jacobian) {
+		fprintf(h, "\t// Same result as fkWithJacobian() on the described arm\n");
+		fprintf(h, "\tvoid fk_jacobian_%s(const float *thetas, linalg::Transform &out, Twist *J);\n", name.c_str());
+	}
+	fprintf(h, "\t// True if fk_%s() agrees with forwardKinematics() on model over a sweep of\n", name.c_str());
+	fprintf(h, "\t// configurations, i.e. model is the described arm and the fast path may stand in for it\n");
+	fprintf(h, "\tbool fk_%s_matches(const RobotModel &model);\n", name.c_str());
+	fprintf(h, "} /*namespace generated*/\n} /*namespace kinematics*/\n\n#endif /*%s*/\n", guard.c_str());
+	fclose(h);
+
+	fprintf(f, "// Generated by fk_codegen from %s. Do not edit.\n", description);
+	fprintf(f, "#include \"fk_%s.h\"\n#include \"kinematics/fk.h\"\n#include <cmath>\n\n", name.c_str());
+	fprintf(f, "void kinematics::generated::fk_%s(const float *thetas, linalg::Transform &out) {\n", name.c_str());
+	emitChain(f, model, false);
+	fprintf(f, "}\n");
+	if (jacobian) {
+		fprintf(f, "\nvoid kinematics::generated::fk_jacobian_%s(const float *thetas, linalg::Transform &out, Twist *J) {\n", name.c_str());
+		emitChain(f, model, true);
+		fprintf(f, "}\n");
+	}
+	// Tolerances allow for the different float rounding of the folded and the generic chain
+	fprintf(f, "\nbool kinematics::generated::fk_%s_matches(const RobotModel &model) {\n", name.c_str());
+	fprintf(f, "\tif (model.nJoints() != fk_%s_joints) {\n\t\treturn false;\n\t}\n", name.c_str());
+	fprintf(f, "\tfor (int k = 0; k < 64; k++) {\n");
+	fprintf(f, "\t\tfloat thetas[fk_%s_joints];\n", name.c_str());
+	fprintf(f, "\t\tfor (int i = 0; i < fk_%s_joints; i++) {\n", name.c_str());
+	fprintf(f, "\t\t\tthetas[i] = 3.0f * sinf(0.37f * k + 1.3f * i);\n\t\t}\n");
+	fprintf(f, "\t\tlinalg::Transform ref, gen;\n");
+	fprintf(f, "\t\tforwardKinematics(model, thetas, ref);\n");
+	fprintf(f, "\t\tfk_%s(thetas, gen);\n", name.c_str());
+	fprintf(f, "\t\tif (linalg::norm(ref.p - gen.p) > 1e-2f) {\n\t\t\treturn false;\n\t\t}\n");
+	fprintf(f, "\t\tfor (int q = 0; q < 9; q++) {\n");
+	fprintf(f, "\t\t\tif (fabsf(ref.R.m[q] - gen.R.m[q]) > 1e-4f) {\n\t\t\t\treturn false;\n\t\t\t}\n\t\t}\n");
+	fprintf(f, "\t}\n\treturn true;\n}\n");
+	fclose(f);
+	return EXIT_SUCCESS;
+}
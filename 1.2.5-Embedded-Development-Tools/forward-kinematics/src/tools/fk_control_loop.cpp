@@ -0,0 +1,166 @@
+// Runs the course arm's control loop at a fixed rate and prints the deadline statistics.
+// Stages per tick: move the target along a joint-space path, solve IK for it,
+// check the solution with FK and turn it into servo angles. The target and check
+// stages use the generated course-arm FK when it matches the model.
+//
+// Usage: fk_control_loop [--rate <hz>] [--seconds <s>] [--fifo <priority>] [--catch-up]
+//                        [--rt-memory] [--cpu <n>] [--warmup <ticks>]
+// --rt-memory locks and prefaults memory before the loop is set up; page faults
+// taken by the stages after the warm-up ticks (default 1) are then violations and
+// fail the run. Without it they are only reported.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include "fk_course_arm.h"
+#include "kinematics/analytic_ik.h"
+#include "kinematics/fk.h"
+#include "runtime/periodic_executor.h"
+#include "runtime/rt_memory.h"
+
+typedef struct ControlState {
+	const kinematics::RobotModel *model;
+	const kinematics::AnalyticIk4 *analytic;
+	kinematics::IkSolver *solver;
+	// fk_course_arm() instead of the generic PoE, set when it was cross-checked against the model
+	bool generated_fk;
+	long tick;
+	float period_s;
+	linalg::Transform target;
+	float thetas[4];
+	float worst_error;
+	float servo_degrees[4];
+} ControlState;
+
+static void stateFk(const ControlState &s, const float *thetas, linalg::Transform &out) {
+	if (s.generated_fk) {
+		kinematics::generated::fk_course_arm(thetas, out);
+	} else {
+		kinematics::forwardKinematics(*s.model, thetas, out);
+	}
+}
+
+// Smooth joint-space path, so every target is reachable
+static void targetStage(void *user) {
+	ControlState &s = *(ControlState *)user;
+	float t = s.tick++ * s.period_s;
+	float path[4] = {0.8f * sinf(0.5f * t), 0.4f + 0.3f * sinf(0.7f * t), 0.5f * cosf(0.3f * t), 0.2f * sinf(1.1f * t)};
+	stateFk(s, path, s.target);
+}
+
+static void ikStage(void *user) {
+	ControlState &s = *(ControlState *)user;
+	s.analytic->solveOrFallback(s.target, *s.solver, s.thetas);
+}
+
+static void checkStage(void *user) {
+	ControlState &s = *(ControlState *)user;
+	linalg::Transform T;
+	stateFk(s, s.thetas, T);
+	float error = linalg::norm(T.p - s.target.p);
+	s.worst_error = error > s.worst_error ? error : s.worst_error;
+}
+
+// Servo angle in degrees with 90 at the zero joint angle, clamped to the servo range
+static void commandStage(void *user) {
+	ControlState &s = *(ControlState *)user;
+	for (int i = 0; i < 4; i++) {
+		float degrees = 90.0f + s.thetas[i] * (180.0f / (float)M_PI);
+		s.servo_degrees[i] = degrees < 0.0f ? 0.0f : (degrees > 180.0f ? 180.0f : degrees);
+	}
+}
+
+int main(int argc, char **argv) {
+	double rate_hz = 1000.0;
+	double seconds = 5.0;
+	runtime::ExecutorOptions options;
+	options.track_page_faults = true;
+	// The first tick touches the stages' code and data for the first time
+	options.fault_warmup_ticks = 1;
+	bool rt_memory = false;
+	runtime::RtMemoryOptions memory_options;
+	for (int i = 1; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--rate") == 0 && has_value) {
+			rate_hz = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--seconds") == 0 && has_value) {
+			seconds = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--fifo") == 0 && has_value) {
+			options.realtime = true;
+			options.priority = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--catch-up") == 0) {
+			options.overrun = runtime::OVERRUN_CATCH_UP;
+		} else if (strcmp(argv[i], "--rt-memory") == 0) {
+			rt_memory = true;
+		} else if (strcmp(argv[i], "--cpu") == 0 && has_value) {
+			rt_memory = true;
+			memory_options.cpu = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+			options.fault_warmup_ticks = atol(argv[++i]);
+		} else {
+			fprintf(stderr, "Usage: %s [--rate <hz>] [--seconds <s>] [--fifo <priority>] [--catch-up]\n"
+					"       [--rt-memory] [--cpu <n>] [--warmup <ticks>]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (rate_hz <= 0 || seconds <= 0) {
+		fprintf(stderr, "Error: rate and duration must be positive.\n");
+		return EXIT_FAILURE;
+	}
+	options.period_ns = (long)(1e9 / rate_hz);
+	runtime::RtMemoryStatus memory_status{false, false, false};
+	if (rt_memory) {
+		memory_status = runtime::enterRealtimeMemoryMode(memory_options);
+	}
+
+	kinematics::RoboticArmSpecs arm;
+	kinematics::RobotModel model = kinematics::makeRobotModel(arm);
+	kinematics::AnalyticIk4 analytic(arm, model);
+	kinematics::IkSolver solver(model);
+	ControlState state;
+	memset(&state, 0, sizeof(state));
+	state.model = &model;
+	state.analytic = &analytic;
+	state.solver = &solver;
+	state.generated_fk = kinematics::generated::fk_course_arm_matches(model);
+	state.period_s = (float)(options.period_ns * 1e-9);
+
+	runtime::PeriodicExecutor executor(options);
+	executor.addStage("target", targetStage, &state);
+	executor.addStage("ik", ikStage, &state);
+	executor.addStage("check", checkStage, &state);
+	executor.addStage("command", commandStage, &state);
+	executor.run((long)(seconds * rate_hz));
+
+	const runtime::ExecutorStats &stats = executor.stats();
+	printf("%.0f Hz for %ld ticks, %s, %s overruns\n", rate_hz, stats.ticks,
+	       executor.ranRealtime() ? "SCHED_FIFO" : "default scheduler",
+	       options.overrun == runtime::OVERRUN_SKIP ? "skipping" : "catching up on");
+	printf("deadline misses %ld, skipped releases %ld\n", stats.deadline_misses, stats.skipped_releases);
+	printf("release latency min %.1f us, mean %.1f us, p99 < %.0f us, max %.1f us\n",
+	       stats.latency_min_ns * 1e-3, executor.latencyMeanNs() * 1e-3,
+	       executor.latencyQuantileNs(0.99) * 1e-3, stats.latency_max_ns * 1e-3);
+	printf("tick max %.1f us\n", stats.tick_max_ns * 1e-3);
+	for (int i = 0; i < stats.n_stages; i++) {
+		const runtime::StageStats &s = stats.stages[i];
+		printf("  %-8s mean %.2f us, max %.1f us\n", s.name, s.runs ? s.total_ns * 1e-3 / s.runs : 0.0, s.max_ns * 1e-3);
+	}
+	printf("worst IK position error %.4f mm, FK %s\n", state.worst_error,
+	       state.generated_fk ? "generated for the course arm" : "generic PoE (generated FK does not match the model)");
+	if (rt_memory) {
+		printf("memory %s, %s\n", memory_status.locked ? "locked" : "not locked",
+		       memory_status.pinned ? (memory_status.cpu_isolated ? "pinned to an isolated CPU" : "pinned to a shared CPU") : "not pinned");
+	}
+	if (stats.fault_ticks > 0 && rt_memory) {
+		printf("VIOLATION: %ld ticks took page faults (%ld minor, %ld major), first at tick %ld\n",
+		       stats.fault_ticks, stats.minor_faults, stats.major_faults, stats.first_fault_tick);
+		return EXIT_FAILURE;
+	}
+	if (stats.fault_ticks > 0) {
+		printf("%ld ticks took page faults (%ld minor, %ld major), first at tick %ld; use --rt-memory to avoid them\n",
+		       stats.fault_ticks, stats.minor_faults, stats.major_faults, stats.first_fault_tick);
+		return EXIT_SUCCESS;
+	}
+	printf("no page faults after %ld warm-up ticks\n", options.fault_warmup_ticks);
+	return EXIT_SUCCESS;
+}
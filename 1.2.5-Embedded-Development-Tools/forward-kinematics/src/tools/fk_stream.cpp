@@ -0,0 +1,77 @@
+// Replays recorded joint angles through FK.
+//
+// Usage: fk_stream <arm_description.txt> [options]
+//   --in <path>       joint angles, '-' for stdin (default)
+//   --out <path>      poses, '-' for stdout (default)
+//   --binary-in       float32 angles instead of text lines
+//   --binary-out      float32 3x4 poses instead of text lines
+//   --chunk <n>       samples per chunk (default 4096)
+//   --queue <n>       chunks in flight (default 8)
+//   --threads <n>     FK worker threads (default one per core)
+//   --cache <path>    binary model cache to load, rewritten when stale (default none)
+// Throughput is reported on stderr.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kinematics/arm_loader.h"
+#include "kinematics/fk_stream.h"
+
+static void usage(const char *program) {
+	fprintf(stderr, "Usage: %s <arm_description.txt> [--in <path>] [--out <path>] [--binary-in] [--binary-out]\n"
+			"       [--chunk <samples>] [--queue <chunks>] [--threads <n>] [--cache <model.bin>]\n", program);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		usage(argv[0]);
+	}
+	const char *in_path = "-";
+	const char *out_path = "-";
+	const char *cache_path = nullptr;
+	kinematics::StreamOptions options;
+	for (int i = 2; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--in") == 0 && has_value) {
+			in_path = argv[++i];
+		} else if (strcmp(argv[i], "--out") == 0 && has_value) {
+			out_path = argv[++i];
+		} else if (strcmp(argv[i], "--binary-in") == 0) {
+			options.input_format = kinematics::STREAM_BINARY;
+		} else if (strcmp(argv[i], "--binary-out") == 0) {
+			options.output_format = kinematics::STREAM_BINARY;
+		} else if (strcmp(argv[i], "--chunk") == 0 && has_value) {
+			options.chunk_samples = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--queue") == 0 && has_value) {
+			options.queue_chunks = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+			options.fk_threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--cache") == 0 && has_value) {
+			cache_path = argv[++i];
+		} else {
+			usage(argv[0]);
+		}
+	}
+
+	kinematics::CachedRobotModel model;
+	kinematics::loadRobotModel(argv[1], cache_path, model);
+
+	FILE *in = strcmp(in_path, "-") == 0 ? stdin : fopen(in_path, options.input_format == kinematics::STREAM_BINARY ? "rb" : "r");
+	FILE *out = strcmp(out_path, "-") == 0 ? stdout : fopen(out_path, options.output_format == kinematics::STREAM_BINARY ? "wb" : "w");
+	if (in == nullptr || out == nullptr) {
+		fprintf(stderr, "Error: cannot open %s.\n", in == nullptr ? in_path : out_path);
+		return EXIT_FAILURE;
+	}
+
+	kinematics::StreamStats stats = kinematics::runFkStream(*model.get(), in, out, options);
+	fprintf(stderr, "%ld samples in %ld chunks, %.3f s, %.0f samples/s\n",
+		stats.samples, stats.chunks, stats.seconds, stats.samples_per_second);
+
+	if (in != stdin) {
+		fclose(in);
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+// Samples the reachable workspace of an arm into a voxel map with orientation coverage.
+//
+// Usage: fk_workspace <arm_description.txt> <map.bin> [options]
+//   --voxel <mm>            voxel edge length (default 5)
+//   --samples <n>           uniform samples within the joint limits (default 2^22)
+//   --grid <points>         evenly spaced joint grid instead, points^joints samples
+//   --orientation-res <k>   6 k^2 approach-direction bins per voxel, k <= 3 (default 3)
+//   --seed <n>              seed for uniform sampling (default 1)
+//   --threads <n>           OpenMP threads (default one per core)
+//   --cache <path>          binary model cache to load, rewritten when stale (default none)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <omp.h>
+#include "kinematics/arm_loader.h"
+#include "kinematics/workspace.h"
+
+static void usage(const char *program) {
+	fprintf(stderr, "Usage: %s <arm_description.txt> <map.bin> [--voxel <mm>] [--samples <n> | --grid <points>]\n"
+			"       [--orientation-res <k>] [--seed <n>] [--threads <n>] [--cache <model.bin>]\n", program);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		usage(argv[0]);
+	}
+	float voxel = 5.0f;
+	int orientation_res = kinematics::MAX_ORIENTATION_RESOLUTION;
+	kinematics::WorkspaceSamplingOptions options;
+	options.samples = 1L << 22;
+	const char *cache_path = nullptr;
+	for (int i = 3; i < argc; i++) {
+		bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--voxel") == 0 && has_value) {
+			voxel = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--samples") == 0 && has_value) {
+			options.mode = kinematics::SAMPLE_UNIFORM;
+			options.samples = atol(argv[++i]);
+		} else if (strcmp(argv[i], "--grid") == 0 && has_value) {
+			options.mode = kinematics::SAMPLE_GRID;
+			options.grid_points = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--orientation-res") == 0 && has_value) {
+			orientation_res = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+			options.seed = strtoull(argv[++i], nullptr, 10);
+		} else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+			omp_set_num_threads(atoi(argv[++i]));
+		} else if (strcmp(argv[i], "--cache") == 0 && has_value) {
+			cache_path = argv[++i];
+		} else {
+			usage(argv[0]);
+		}
+	}
+
+	kinematics::CachedRobotModel model;
+	kinematics::loadRobotModel(argv[1], cache_path, model);
+
+	kinematics::WorkspaceMap map(kinematics::workspaceBounds(*model.get(), voxel, orientation_res));
+	auto start = std::chrono::steady_clock::now();
+	kinematics::sampleWorkspace(*model.get(), options, map);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!map.write(argv[2])) {
+		fprintf(stderr, "Error: cannot write %s.\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+
+	const kinematics::WorkspaceGridSpec &spec = map.spec();
+	long reachable = map.reachableVoxels();
+	double coverage = 0;
+	for (long v = 0; v < map.nVoxels(); v++) {
+		coverage += map.hits(v) ? map.reachability(v) : 0.0f;
+	}
+	printf("%ld samples on %d threads in %.3f s (%.2f M samples/s)\n", map.samples(), omp_get_max_threads(), seconds,
+	       map.samples() / seconds * 1e-6);
+	printf("grid %d x %d x %d of %.1f mm voxels, %ld reachable (%.1f cm^3), %ld samples outside\n",
+	       spec.nx, spec.ny, spec.nz, spec.voxel_size, reachable, reachable * spec.voxel_size * spec.voxel_size * spec.voxel_size * 1e-3,
+	       map.outside());
+	printf("mean orientation coverage of reachable voxels %.1f%% of %d bins\n",
+	       reachable ? 100.0 * coverage / reachable : 0.0, map.orientationBins());
+	return EXIT_SUCCESS;
+}